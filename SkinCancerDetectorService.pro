@@ -1,8 +1,9 @@
 QT -= gui
-QT += remoteobjects
+QT += remoteobjects network
 
 TENSOR_RT_BUILD = $$(ENABLE_TENSOR_RT_BUILD)
 TORCH_BUILD = $$(ENABLE_TORCH_BUILD)
+ONNX_RUNTIME_BUILD = $$(ENABLE_ONNX_RUNTIME_BUILD)
 
 isEqual(TENSOR_RT_BUILD, "ON") {
 message("TensorRT build included!")
@@ -14,6 +15,11 @@ message("Torch build included!")
 CONFIG += torch
 }
 
+isEqual(ONNX_RUNTIME_BUILD, "ON") {
+message("ONNX Runtime build included!")
+CONFIG += onnxruntime
+}
+
 CONFIG += c++17 console
 CONFIG += file_copies
 CONFIG += object_parallel_to_source
@@ -29,29 +35,54 @@ HEADERS += \
     src/engines/BaseTensorEngine.h \
     src/engines/BaseTensorEngineSettings.h \
     src/engines/ITensorEngine.h \
+    src/engines/opencv/TensorEngine.h \
+    src/engines/opencv/TensorEngineSettings.h \
+    src/engines/synthetic/TensorEngine.h \
+    src/engines/synthetic/TensorEngineSettings.h \
     src/image/IImageConvertor.h \
     src/image/ImageConvertorSettings.h \
     src/image/opencv/ImageConvertor.h \
+    src/service/BatchingPolicy.h \
+    src/service/FlightRecorder.h \
     src/service/ImageConvertorWorker.h \
+    src/service/LatencyEstimator.h \
+    src/service/Metrics.h \
+    src/service/MetricsServer.h \
+    src/service/RequestOptions.h \
     src/service/Service.h \
     src/service/ServiceSettings.h \
+    src/service/TensorEngineDispatcher.h \
     src/service/TensorEngineWorker.h \
     src/utils/JsonHelper.h \
+    src/utils/MpmcRingBuffer.h \
     src/utils/ServiceLocator.h \
-    src/utils/SettingsReader.h
+    src/utils/SettingsReader.h \
+    src/utils/ThreadAffinity.h \
+    src/utils/WorkStealingExecutor.h
 
 SOURCES += \
     src/engines/BaseTensorEngine.cpp \
     src/engines/BaseTensorEngineSettings.cpp \
+    src/engines/opencv/TensorEngine.cpp \
+    src/engines/opencv/TensorEngineSettings.cpp \
+    src/engines/synthetic/TensorEngine.cpp \
+    src/engines/synthetic/TensorEngineSettings.cpp \
     src/image/ImageConvertorSettings.cpp \
     src/image/opencv/ImageConvertor.cpp \
     src/main.cpp \
+    src/service/BatchingPolicy.cpp \
+    src/service/FlightRecorder.cpp \
     src/service/ImageConvertorWorker.cpp \
+    src/service/LatencyEstimator.cpp \
+    src/service/Metrics.cpp \
+    src/service/MetricsServer.cpp \
     src/service/Service.cpp \
     src/service/ServiceSettings.cpp \
+    src/service/TensorEngineDispatcher.cpp \
     src/service/TensorEngineWorker.cpp \
     src/utils/ServiceLocator.cpp \
-    src/utils/SettingsReader.cpp
+    src/utils/SettingsReader.cpp \
+    src/utils/ThreadAffinity.cpp
 
 tensorrt {
 DEFINES += INCLUDE_TENSOR_RT_BUILD
@@ -76,6 +107,18 @@ SOURCES += \
     src/engines/torch/TensorEngineSettings.cpp
 }
 
+onnxruntime {
+DEFINES += INCLUDE_ONNX_RUNTIME_BUILD
+
+HEADERS += \
+    src/engines/onnxruntime/TensorEngine.h \
+    src/engines/onnxruntime/TensorEngineSettings.h
+
+SOURCES += \
+    src/engines/onnxruntime/TensorEngine.cpp \
+    src/engines/onnxruntime/TensorEngineSettings.cpp
+}
+
 REPC_SOURCE += \
     src/service/SkinCancerDetectorService.rep
 
@@ -100,10 +143,10 @@ DEPENDPATH += $$(OPENCV_INCLUDE)
 OPENCV_LIBS_EXIST = $$(OPENCV_LIBS)
 
 isEmpty(OPENCV_LIBS_EXIST) {
-LIBS += -lopencv_core -lopencv_imgproc -lopencv_highgui -lopencv_imgcodecs -lopencv_videoio
+LIBS += -lopencv_core -lopencv_imgproc -lopencv_highgui -lopencv_imgcodecs -lopencv_videoio -lopencv_dnn
 }
 else {
-LIBS += -L$$(OPENCV_LIBS) -lopencv_core -lopencv_imgproc -lopencv_highgui -lopencv_imgcodecs -lopencv_videoio
+LIBS += -L$$(OPENCV_LIBS) -lopencv_core -lopencv_imgproc -lopencv_highgui -lopencv_imgcodecs -lopencv_videoio -lopencv_dnn
 }
 
 
@@ -126,3 +169,10 @@ DEPENDPATH += $$(TORCH_ROOT)/include/torch/csrc/api/include/
 
 LIBS += -L$$(TORCH_ROOT)/lib/ -ltorch -lnnpack -lc10
 }
+
+onnxruntime {
+INCLUDEPATH += $$(ONNX_RUNTIME_ROOT)/include
+DEPENDPATH += $$(ONNX_RUNTIME_ROOT)/include
+
+LIBS += -L$$(ONNX_RUNTIME_ROOT)/lib/ -lonnxruntime
+}
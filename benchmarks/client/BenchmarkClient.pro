@@ -0,0 +1,23 @@
+QT -= gui
+QT += remoteobjects
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = SkinCancerDetectorBenchmark
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+HEADERS += \
+    src/BenchmarkClient.h \
+    src/BenchmarkOptions.h
+
+SOURCES += \
+    src/BenchmarkClient.cpp \
+    src/BenchmarkOptions.cpp \
+    src/main.cpp
+
+REPC_REPLICA += \
+    ../../src/service/SkinCancerDetectorService.rep
+
+INCLUDEPATH += src/
@@ -0,0 +1,398 @@
+#include "BenchmarkClient.h"
+
+#include <QRemoteObjectPendingCallWatcher>
+#include <QLoggingCategory>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMetaEnum>
+#include <QFileInfo>
+#include <QFile>
+#include <QDir>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+
+namespace benchmark
+{
+Q_LOGGING_CATEGORY(QLC_BENCHMARK_CLIENT, "BenchmarkClient")
+
+static constexpr int CONNECT_TIMEOUT_MS = 10000;
+static constexpr int SEND_INTERVAL_MS = 1;
+static QStringList const IMAGE_FILTERS = {"*.jpg", "*.jpeg", "*.png", "*.bmp"};
+
+static QString errorName(SkinCancerDetectorServiceReplica::ErrorType error)
+{
+    auto const name = QMetaEnum::fromType<SkinCancerDetectorServiceReplica::ErrorType>().valueToKey(error);
+    return name ? name : "Unknown";
+}
+
+// nearest rank percentile of sorted values
+static double percentile(std::vector<double> const& sorted, double p)
+{
+    if (sorted.empty())
+    {
+        return 0;
+    }
+
+    auto const rank = static_cast<size_t>(std::ceil(p * sorted.size()));
+    return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+static QJsonObject distribution(std::vector<double> values)
+{
+    std::sort(values.begin(), values.end());
+
+    auto const mean = values.empty() ? 0 : std::accumulate(values.begin(), values.end(), 0.0) / values.size();
+
+    return QJsonObject{
+        {"count", static_cast<qint64>(values.size())},
+        {"mean", mean},
+        {"min", values.empty() ? 0 : values.front()},
+        {"p50", percentile(values, 0.5)},
+        {"p90", percentile(values, 0.9)},
+        {"p99", percentile(values, 0.99)},
+        {"p999", percentile(values, 0.999)},
+        {"max", values.empty() ? 0 : values.back()}
+    };
+}
+
+BenchmarkClient::BenchmarkClient(BenchmarkOptions const& options, QObject* parent)
+    : QObject(parent)
+    , m_options(options)
+{
+    qRegisterMetaType<QList<SkinCancerDetectorRequestInfo>>();
+    qRegisterMetaTypeStreamOperators<QList<SkinCancerDetectorRequestInfo>>();
+    qRegisterMetaType<QList<SkinCancerDetectorRequestResult>>();
+    qRegisterMetaTypeStreamOperators<QList<SkinCancerDetectorRequestResult>>();
+
+    m_sendTimer.setTimerType(Qt::PreciseTimer);
+    m_sendTimer.setInterval(SEND_INTERVAL_MS);
+    m_stopTimer.setSingleShot(true);
+    m_drainTimer.setSingleShot(true);
+
+    connect(&m_sendTimer, &QTimer::timeout, this, &BenchmarkClient::sendDue);
+    connect(&m_stopTimer, &QTimer::timeout, this, &BenchmarkClient::stopSending);
+    connect(&m_drainTimer, &QTimer::timeout, this, &BenchmarkClient::finish);
+}
+
+bool BenchmarkClient::start()
+{
+    if (!loadImages())
+    {
+        return false;
+    }
+
+    qCInfo(QLC_BENCHMARK_CLIENT) << "Trying to connect" << m_options.url();
+
+    if (!m_node.connectToNode(m_options.url()))
+    {
+        qCCritical(QLC_BENCHMARK_CLIENT) << "Connect to node failed:"
+                                         << QMetaEnum::fromType<QRemoteObjectNode::ErrorCode>().valueToKey(m_node.lastError());
+        return false;
+    }
+
+    m_replica.reset(m_node.acquire<SkinCancerDetectorServiceReplica>());
+
+    connect(m_replica.get(), &SkinCancerDetectorServiceReplica::resultReady, this,
+            [this] (quint64 id, SkinCancerDetectorResult) {
+        onReceived(id, SkinCancerDetectorServiceReplica::NoError);
+    });
+    connect(m_replica.get(), &SkinCancerDetectorServiceReplica::resultFailed, this,
+            [this] (quint64 id, SkinCancerDetectorServiceReplica::ErrorType error) {
+        onReceived(id, error);
+    });
+
+    if (!m_replica->waitForSource(CONNECT_TIMEOUT_MS))
+    {
+        qCCritical(QLC_BENCHMARK_CLIENT) << "Service is not available";
+        return false;
+    }
+
+    qCInfo(QLC_BENCHMARK_CLIENT) << "Connected successfully";
+
+    run();
+    return true;
+}
+
+bool BenchmarkClient::loadImages()
+{
+    QDir const dir(m_options.imagesDir());
+    for (auto const& info : dir.entryInfoList(IMAGE_FILTERS, QDir::Files, QDir::Name))
+    {
+        if (m_options.sendPaths())
+        {
+            m_paths.append(info.absoluteFilePath());
+            continue;
+        }
+
+        QFile file(info.absoluteFilePath());
+        if (!file.open(QFile::ReadOnly))
+        {
+            qCWarning(QLC_BENCHMARK_CLIENT) << "Cannot open image:" << file.fileName() << "error:" << file.errorString();
+            continue;
+        }
+        m_images.append(file.readAll());
+    }
+
+    auto const count = m_options.sendPaths() ? m_paths.size() : m_images.size();
+    if (count == 0)
+    {
+        qCCritical(QLC_BENCHMARK_CLIENT) << "No images in directory:" << m_options.imagesDir();
+        return false;
+    }
+
+    qCInfo(QLC_BENCHMARK_CLIENT) << "Loaded" << count << "images";
+    return true;
+}
+
+void BenchmarkClient::run()
+{
+    m_sending = true;
+    m_measureStartNs = static_cast<qint64>(m_options.warmupSec() * 1e9);
+    m_clock.start();
+    m_stopTimer.start(static_cast<int>((m_options.warmupSec() + m_options.durationSec()) * 1000));
+
+    if (m_options.mode() == BenchmarkOptions::Mode::OpenLoop)
+    {
+        qCInfo(QLC_BENCHMARK_CLIENT) << "Open loop with rate" << m_options.rate() << "requests per second";
+        m_sendTimer.start();
+    }
+    else
+    {
+        qCInfo(QLC_BENCHMARK_CLIENT) << "Closed loop with concurrency" << m_options.concurrency();
+        for (int i = 0; i < m_options.concurrency(); ++i)
+        {
+            send(m_clock.nsecsElapsed());
+        }
+    }
+}
+
+void BenchmarkClient::sendDue()
+{
+    // requests are sent by schedule regardless of responses,
+    // latency is taken from scheduled time so stalls of client or service are not hidden
+    auto const elapsedSec = m_clock.nsecsElapsed() / 1e9;
+    auto const due = static_cast<qint64>(elapsedSec * m_options.rate());
+
+    for (; m_scheduled < due; ++m_scheduled)
+    {
+        send(static_cast<qint64>(m_scheduled * 1e9 / m_options.rate()));
+    }
+}
+
+void BenchmarkClient::send(qint64 sentNs)
+{
+    Request request;
+    request.sentNs = sentNs;
+    request.measured = sentNs >= m_measureStartNs;
+    m_sent += request.measured;
+
+    auto const priority = static_cast<SkinCancerDetectorServiceReplica::Priority>(m_options.priority());
+    auto const reply = m_options.sendPaths()
+            ? m_replica->request(m_paths[m_nextImage++ % m_paths.size()], priority, m_options.deadlineMs())
+            : m_replica->request(m_images[m_nextImage++ % m_images.size()], priority, m_options.deadlineMs());
+
+    m_pendingReplies++;
+    auto const watcher = new QRemoteObjectPendingCallWatcher(reply, this);
+    connect(watcher, &QRemoteObjectPendingCallWatcher::finished, this, [this, request] (QRemoteObjectPendingCallWatcher* watcher) {
+        onRequested(watcher, request);
+    });
+}
+
+void BenchmarkClient::onRequested(QRemoteObjectPendingCallWatcher* watcher, Request const& request)
+{
+    watcher->deleteLater();
+    m_pendingReplies--;
+
+    if (watcher->error() != QRemoteObjectPendingCall::NoError)
+    {
+        evictEarly(0);
+        complete(request, m_clock.nsecsElapsed(), SkinCancerDetectorServiceReplica::System);
+        m_transportErrors += request.measured;
+        return;
+    }
+
+    auto const info = watcher->returnValue().value<SkinCancerDetectorRequestInfo>();
+
+    auto inFlight = request;
+    inFlight.estimateMs = info.estimateMs();
+
+    // rejected request is failed before its id is replied
+    auto const early = m_early.find(info.id());
+    if (early != m_early.end())
+    {
+        auto const received = early.value();
+        m_early.erase(early);
+        evictEarly(info.id());
+        complete(inFlight, received.receivedNs, received.error);
+        return;
+    }
+
+    evictEarly(info.id());
+    m_inFlight.insert(info.id(), inFlight);
+}
+
+void BenchmarkClient::evictEarly(quint64 repliedId)
+{
+    if (m_pendingReplies == 0)
+    {
+        m_early.clear();
+        return;
+    }
+
+    // ids are increasing and replied in order, so older results belong to other clients
+    for (auto it = m_early.begin(); it != m_early.end();)
+    {
+        if (it.key() < repliedId)
+        {
+            it = m_early.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+void BenchmarkClient::onReceived(quint64 id, SkinCancerDetectorServiceReplica::ErrorType error)
+{
+    auto const receivedNs = m_clock.nsecsElapsed();
+
+    auto const it = m_inFlight.find(id);
+    if (it != m_inFlight.end())
+    {
+        auto const request = it.value();
+        m_inFlight.erase(it);
+        complete(request, receivedNs, error);
+        return;
+    }
+
+    // results of other clients are kept only while own ids are not replied
+    if (m_pendingReplies > 0)
+    {
+        m_early.insert(id, {receivedNs, error});
+    }
+}
+
+void BenchmarkClient::complete(Request const& request, qint64 receivedNs, SkinCancerDetectorServiceReplica::ErrorType error)
+{
+    if (request.measured)
+    {
+        m_lastCompletedNs = std::max(m_lastCompletedNs, receivedNs);
+
+        if (error == SkinCancerDetectorServiceReplica::NoError)
+        {
+            auto const latencyMs = (receivedNs - request.sentNs) / 1e6;
+            m_latenciesMs.push_back(latencyMs);
+            if (request.estimateMs >= 0)
+            {
+                m_estimateErrorsMs.push_back(latencyMs - request.estimateMs);
+            }
+        }
+        else
+        {
+            m_errors[errorName(error)]++;
+        }
+    }
+
+    if (m_sending && m_options.mode() == BenchmarkOptions::Mode::ClosedLoop)
+    {
+        send(m_clock.nsecsElapsed());
+    }
+    else if (!m_sending && m_inFlight.isEmpty() && m_pendingReplies == 0)
+    {
+        finish();
+    }
+}
+
+void BenchmarkClient::stopSending()
+{
+    m_sending = false;
+    m_sendTimer.stop();
+
+    if (m_inFlight.isEmpty() && m_pendingReplies == 0)
+    {
+        finish();
+        return;
+    }
+
+    qCInfo(QLC_BENCHMARK_CLIENT) << "Waiting for" << m_inFlight.size() + m_pendingReplies << "requests in flight";
+    m_drainTimer.start(static_cast<int>(m_options.drainSec() * 1000));
+}
+
+void BenchmarkClient::finish()
+{
+    if (m_finished)
+    {
+        return;
+    }
+
+    m_finished = true;
+    m_sendTimer.stop();
+    m_stopTimer.stop();
+    m_drainTimer.stop();
+
+    qCInfo(QLC_BENCHMARK_CLIENT) << "Benchmark is finished";
+    emit finished(report());
+}
+
+QByteArray BenchmarkClient::report() const
+{
+    auto const succeeded = static_cast<quint64>(m_latenciesMs.size());
+    auto const failed = std::accumulate(m_errors.begin(), m_errors.end(), quint64(0));
+    auto const lost = static_cast<quint64>(std::count_if(m_inFlight.begin(), m_inFlight.end(), [] (Request const& request) {
+        return request.measured;
+    })) + static_cast<quint64>(m_pendingReplies);
+
+    // window is from end of warmup till last measured result
+    auto windowSec = (m_lastCompletedNs - m_measureStartNs) / 1e9;
+    if (windowSec <= 0)
+    {
+        windowSec = m_options.durationSec();
+    }
+
+    QJsonObject errors;
+    for (auto it = m_errors.cbegin(); it != m_errors.cend(); ++it)
+    {
+        errors.insert(it.key(), static_cast<qint64>(it.value()));
+    }
+
+    std::vector<double> absoluteErrorsMs;
+    for (auto const error : m_estimateErrorsMs)
+    {
+        absoluteErrorsMs.push_back(std::abs(error));
+    }
+    auto const underestimated = std::count_if(m_estimateErrorsMs.begin(), m_estimateErrorsMs.end(), [] (double error) {
+        return error > 0;
+    });
+
+    auto const isOpenLoop = m_options.mode() == BenchmarkOptions::Mode::OpenLoop;
+
+    QJsonObject const report{
+        {"mode", isOpenLoop ? "open" : "closed"},
+        {"rate", isOpenLoop ? m_options.rate() : 0},
+        {"concurrency", isOpenLoop ? 0 : m_options.concurrency()},
+        {"warmupSec", m_options.warmupSec()},
+        {"durationSec", m_options.durationSec()},
+        {"windowSec", windowSec},
+        {"sent", static_cast<qint64>(m_sent)},
+        {"succeeded", static_cast<qint64>(succeeded)},
+        {"failed", static_cast<qint64>(failed)},
+        {"lost", static_cast<qint64>(lost)},
+        {"transportErrors", static_cast<qint64>(m_transportErrors)},
+        {"errors", errors},
+        {"throughput", succeeded / windowSec},
+        {"latencyMs", distribution(m_latenciesMs)},
+        {"estimate", QJsonObject{
+             // error is actual latency minus estimate, positive is underestimated
+             {"errorMs", distribution(m_estimateErrorsMs)},
+             {"absoluteErrorMs", distribution(absoluteErrorsMs)},
+             {"underestimatedRatio", m_estimateErrorsMs.empty() ? 0 : static_cast<double>(underestimated) / m_estimateErrorsMs.size()}
+         }}
+    };
+
+    return QJsonDocument(report).toJson(QJsonDocument::Indented);
+}
+}
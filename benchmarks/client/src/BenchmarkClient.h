@@ -0,0 +1,108 @@
+#pragma once
+
+#include <rep_SkinCancerDetectorService_replica.h>
+#include <QRemoteObjectNode>
+#include <QElapsedTimer>
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QTimer>
+
+#include <memory>
+#include <vector>
+
+#include "BenchmarkOptions.h"
+
+
+class QRemoteObjectPendingCallWatcher;
+
+namespace benchmark
+{
+/**
+ * @brief The BenchmarkClient class - load generator for SkinCancerDetectorService
+ * replays images in open loop (fixed arrival rate) or closed loop (fixed concurrency),
+ * matches results with requests by id and reports latency and estimate accuracy as JSON
+ */
+class BenchmarkClient : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit BenchmarkClient(BenchmarkOptions const& options, QObject* parent = nullptr);
+
+    /**
+     * @brief load images, connect to service and start sending
+     * @return success
+     */
+    bool start();
+
+signals:
+    /**
+     * @brief benchmark is finished
+     * @param report - JSON report
+     */
+    void finished(QByteArray const& report);
+
+private:
+    // request sent to service, waiting for id or result
+    struct Request
+    {
+        qint64 sentNs = 0;
+        qint64 estimateMs = -1;
+        bool measured = false;
+    };
+
+    // result received before id of request
+    struct Received
+    {
+        qint64 receivedNs = 0;
+        SkinCancerDetectorServiceReplica::ErrorType error = SkinCancerDetectorServiceReplica::NoError;
+    };
+
+private:
+    bool loadImages();
+    void run();
+    void sendDue();
+    void send(qint64 sentNs);
+    void onRequested(QRemoteObjectPendingCallWatcher* watcher, Request const& request);
+    void onReceived(quint64 id, SkinCancerDetectorServiceReplica::ErrorType error);
+    void evictEarly(quint64 repliedId);
+    void complete(Request const& request, qint64 receivedNs, SkinCancerDetectorServiceReplica::ErrorType error);
+    void stopSending();
+    void finish();
+    QByteArray report() const;
+
+private:
+    BenchmarkOptions m_options{};
+
+    QRemoteObjectNode m_node{};
+    std::unique_ptr<SkinCancerDetectorServiceReplica> m_replica{};
+
+    QList<QByteArray> m_images{};
+    QStringList m_paths{};
+    int m_nextImage = 0;
+
+    QElapsedTimer m_clock{};
+    QTimer m_sendTimer{};
+    QTimer m_stopTimer{};
+    QTimer m_drainTimer{};
+    bool m_sending = false;
+    bool m_finished = false;
+    qint64 m_scheduled = 0;
+
+    // requests waiting for id and requests waiting for result
+    int m_pendingReplies = 0;
+    QHash<quint64, Request> m_inFlight{};
+    QHash<quint64, Received> m_early{};
+
+    // measured
+    qint64 m_measureStartNs = 0;
+    qint64 m_lastCompletedNs = 0;
+    quint64 m_sent = 0;
+    quint64 m_transportErrors = 0;
+    QMap<QString, quint64> m_errors{};
+    std::vector<double> m_latenciesMs{};
+    std::vector<double> m_estimateErrorsMs{};
+};
+}
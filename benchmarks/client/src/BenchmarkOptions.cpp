@@ -0,0 +1,155 @@
+#include "BenchmarkOptions.h"
+
+#include <QCommandLineParser>
+#include <QLoggingCategory>
+
+
+namespace benchmark
+{
+Q_LOGGING_CATEGORY(QLC_BENCHMARK_OPTIONS, "BenchmarkOptions")
+
+static constexpr auto DEFAULT_URL = "local:skin_cancer_detector";
+static constexpr int PRIORITIES = 4;
+
+bool BenchmarkOptions::parse(QStringList const& arguments)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("End-to-end benchmark client of SkinCancerDetectorService");
+    parser.addHelpOption();
+
+    QCommandLineOption const urlOption("url", "Url of service.", "url", DEFAULT_URL);
+    QCommandLineOption const imagesOption("images", "Directory with replayed images.", "dir");
+    QCommandLineOption const modeOption("mode", "Mode of load: open (fixed arrival rate) or closed (fixed concurrency).",
+                                        "mode", "closed");
+    QCommandLineOption const rateOption("rate", "Arrival rate in requests per second for open mode.", "rps", "10");
+    QCommandLineOption const concurrencyOption("concurrency", "Count of requests in flight for closed mode.", "n", "1");
+    QCommandLineOption const warmupOption("warmup", "Warmup time in seconds, not measured.", "sec", "1");
+    QCommandLineOption const durationOption("duration", "Measured time of sending in seconds.", "sec", "10");
+    QCommandLineOption const drainOption("drain", "Max time in seconds of waiting requests in flight.", "sec", "30");
+    QCommandLineOption const priorityOption("priority", "Priority of requests: 0 - Low, 1 - Normal, 2 - High, 3 - Urgent.",
+                                            "priority", "1");
+    QCommandLineOption const deadlineOption("deadline", "Deadline of requests in ms (0 - no deadline).", "ms", "0");
+    QCommandLineOption const pathsOption("paths", "Send paths to images instead of binary data.");
+    QCommandLineOption const outputOption("output", "Path to JSON report (default - stdout).", "path");
+
+    parser.addOptions({urlOption, imagesOption, modeOption, rateOption, concurrencyOption, warmupOption,
+                       durationOption, drainOption, priorityOption, deadlineOption, pathsOption, outputOption});
+    parser.process(arguments);
+
+    auto ok = true;
+    auto const toDouble = [&parser, &ok] (QCommandLineOption const& option) {
+        bool converted = false;
+        auto const value = parser.value(option).toDouble(&converted);
+        if (!converted || value < 0)
+        {
+            qCCritical(QLC_BENCHMARK_OPTIONS) << "Invalid value of" << option.names().first() << parser.value(option);
+            ok = false;
+        }
+        return value;
+    };
+
+    m_url = QUrl(parser.value(urlOption));
+    m_imagesDir = parser.value(imagesOption);
+    m_rate = toDouble(rateOption);
+    m_concurrency = static_cast<int>(toDouble(concurrencyOption));
+    m_warmupSec = toDouble(warmupOption);
+    m_durationSec = toDouble(durationOption);
+    m_drainSec = toDouble(drainOption);
+    m_priority = static_cast<int>(toDouble(priorityOption));
+    m_deadlineMs = static_cast<qint64>(toDouble(deadlineOption));
+    m_sendPaths = parser.isSet(pathsOption);
+    m_output = parser.value(outputOption);
+
+    auto const mode = parser.value(modeOption);
+    if (mode == "open")
+    {
+        m_mode = Mode::OpenLoop;
+        ok = ok && m_rate > 0;
+    }
+    else if (mode == "closed")
+    {
+        m_mode = Mode::ClosedLoop;
+        ok = ok && m_concurrency > 0;
+    }
+    else
+    {
+        qCCritical(QLC_BENCHMARK_OPTIONS) << "Unknown mode:" << mode;
+        ok = false;
+    }
+
+    if (m_imagesDir.isEmpty())
+    {
+        qCCritical(QLC_BENCHMARK_OPTIONS) << "Directory with images is not set";
+        ok = false;
+    }
+
+    ok = ok && m_url.isValid() && m_durationSec > 0 && m_priority < PRIORITIES;
+
+    if (!ok)
+    {
+        qCCritical(QLC_BENCHMARK_OPTIONS) << "Invalid options, see --help";
+    }
+
+    return ok;
+}
+
+QUrl const& BenchmarkOptions::url() const
+{
+    return m_url;
+}
+
+QString const& BenchmarkOptions::imagesDir() const
+{
+    return m_imagesDir;
+}
+
+BenchmarkOptions::Mode BenchmarkOptions::mode() const
+{
+    return m_mode;
+}
+
+double BenchmarkOptions::rate() const
+{
+    return m_rate;
+}
+
+int BenchmarkOptions::concurrency() const
+{
+    return m_concurrency;
+}
+
+double BenchmarkOptions::warmupSec() const
+{
+    return m_warmupSec;
+}
+
+double BenchmarkOptions::durationSec() const
+{
+    return m_durationSec;
+}
+
+double BenchmarkOptions::drainSec() const
+{
+    return m_drainSec;
+}
+
+int BenchmarkOptions::priority() const
+{
+    return m_priority;
+}
+
+qint64 BenchmarkOptions::deadlineMs() const
+{
+    return m_deadlineMs;
+}
+
+bool BenchmarkOptions::sendPaths() const
+{
+    return m_sendPaths;
+}
+
+QString const& BenchmarkOptions::output() const
+{
+    return m_output;
+}
+}
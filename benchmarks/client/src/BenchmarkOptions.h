@@ -0,0 +1,118 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QUrl>
+
+
+namespace benchmark
+{
+/**
+ * @brief The BenchmarkOptions class - options of benchmark client from command line
+ */
+class BenchmarkOptions
+{
+public:
+    enum class Mode
+    {
+        OpenLoop,  // requests are sent with fixed arrival rate
+        ClosedLoop // fixed count of requests is in flight
+    };
+
+public:
+    BenchmarkOptions() = default;
+
+    /**
+     * @brief parse options from command line arguments
+     * @param arguments - arguments of application
+     * @return success
+     */
+    bool parse(QStringList const& arguments);
+
+    /**
+     * @brief url of service
+     * @return
+     */
+    QUrl const& url() const;
+
+    /**
+     * @brief directory with replayed images
+     * @return
+     */
+    QString const& imagesDir() const;
+
+    /**
+     * @brief mode of load
+     * @return
+     */
+    Mode mode() const;
+
+    /**
+     * @brief arrival rate in requests per second for open loop
+     * @return
+     */
+    double rate() const;
+
+    /**
+     * @brief count of requests in flight for closed loop
+     * @return
+     */
+    int concurrency() const;
+
+    /**
+     * @brief time in seconds of warmup, results of warmup are not measured
+     * @return
+     */
+    double warmupSec() const;
+
+    /**
+     * @brief time in seconds of measured sending
+     * @return
+     */
+    double durationSec() const;
+
+    /**
+     * @brief max time in seconds of waiting requests in flight after sending, rest are lost
+     * @return
+     */
+    double drainSec() const;
+
+    /**
+     * @brief priority of requests (SkinCancerDetectorService::Priority)
+     * @return
+     */
+    int priority() const;
+
+    /**
+     * @brief deadline in ms of requests (0 - no deadline)
+     * @return
+     */
+    qint64 deadlineMs() const;
+
+    /**
+     * @brief send paths to images instead of binary data (service must be local)
+     * @return
+     */
+    bool sendPaths() const;
+
+    /**
+     * @brief path to JSON report (empty - stdout)
+     * @return
+     */
+    QString const& output() const;
+
+private:
+    QUrl m_url{};
+    QString m_imagesDir{};
+    Mode m_mode = Mode::ClosedLoop;
+    double m_rate = 0;
+    int m_concurrency = 0;
+    double m_warmupSec = 0;
+    double m_durationSec = 0;
+    double m_drainSec = 0;
+    int m_priority = 0;
+    qint64 m_deadlineMs = 0;
+    bool m_sendPaths = false;
+    QString m_output{};
+};
+}
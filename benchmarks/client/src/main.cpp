@@ -0,0 +1,51 @@
+#include <QCoreApplication>
+#include <QLoggingCategory>
+#include <QTextStream>
+#include <QFile>
+
+#include "BenchmarkClient.h"
+#include "BenchmarkOptions.h"
+
+
+Q_LOGGING_CATEGORY(QLC_BENCHMARK, "Benchmark")
+
+int main(int argn, char* argv[])
+{
+    qSetMessagePattern("%{time hh:mm::ss.zzz} [%{type}] %{category}: %{message}");
+
+    QCoreApplication app(argn, argv);
+
+    benchmark::BenchmarkOptions options;
+    if (!options.parse(app.arguments()))
+    {
+        return 1;
+    }
+
+    benchmark::BenchmarkClient client(options);
+    QObject::connect(&client, &benchmark::BenchmarkClient::finished, &app, [&options] (QByteArray const& report) {
+        if (options.output().isEmpty())
+        {
+            QTextStream(stdout) << report;
+            QCoreApplication::exit(0);
+            return;
+        }
+
+        QFile file(options.output());
+        if (!file.open(QFile::WriteOnly | QFile::Truncate) || file.write(report) != report.size())
+        {
+            qCCritical(QLC_BENCHMARK) << "Cannot write report:" << options.output() << "error:" << file.errorString();
+            QCoreApplication::exit(1);
+            return;
+        }
+
+        qCInfo(QLC_BENCHMARK) << "Report is written to" << options.output();
+        QCoreApplication::exit(0);
+    });
+
+    if (!client.start())
+    {
+        return 1;
+    }
+
+    return app.exec();
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+
+
+namespace benchmark
+{
+/**
+ * @brief The AllocationCounter class - count of heap allocations of process
+ * malloc family is interposed on glibc, so allocations of OpenCV and codecs are counted too
+ */
+class AllocationCounter
+{
+public:
+    /**
+     * @brief counting is supported on this platform
+     * @return
+     */
+    static bool supported();
+
+    /**
+     * @brief count of allocations since start of process
+     * @return
+     */
+    static uint64_t count();
+};
+}
@@ -0,0 +1,269 @@
+#include "ImageConvertorBenchmark.h"
+#include "AllocationCounter.h"
+
+#include <QLoggingCategory>
+#include <QTemporaryDir>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QFile>
+
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+
+#include <algorithm>
+
+
+namespace benchmark
+{
+Q_LOGGING_CATEGORY(QLC_IMAGE_CONVERTOR_BENCHMARK, "ImageConvertorBenchmark")
+
+static constexpr size_t WARMUP_ITERATIONS = 2;
+static constexpr int JPEG_QUALITY = 95;
+static constexpr int PNG_COMPRESSION = 3;
+static constexpr quint64 NOISE_SEED = 42;
+
+/**
+ * Steps of ImageConvertor::prepare, in order of pipeline
+ */
+enum StepIndex
+{
+    Decode,
+    Read,
+    Crop,
+    Resize,
+    Split,
+    ConvertTo,
+    DivideScale,
+    SubtractMean,
+    DivideStd,
+    StepsCount
+};
+
+template <typename Step, typename Function>
+static void measure(Step& step, bool measured, Function const& function)
+{
+    auto const allocations = AllocationCounter::count();
+    QElapsedTimer timer;
+    timer.start();
+
+    function();
+
+    auto const nsecs = timer.nsecsElapsed();
+    if (measured)
+    {
+        step.nsecs += nsecs;
+        step.allocations += AllocationCounter::count() - allocations;
+    }
+}
+
+ImageConvertorBenchmark::ImageConvertorBenchmark(image::ImageConvertorSettings const& settings, size_t iterations)
+    : m_settings(settings)
+    , m_iterations(std::max<size_t>(iterations, 1))
+{
+    m_convertor.load(m_settings);
+}
+
+QJsonObject ImageConvertorBenchmark::run(QList<cv::Size> const& resolutions)
+{
+    QJsonArray results;
+    for (auto const& size : resolutions)
+    {
+        for (auto const& format : {QString(".jpg"), QString(".png")})
+        {
+            qCInfo(QLC_IMAGE_CONVERTOR_BENCHMARK) << "Measure" << size.width << "x" << size.height << format;
+            results.append(runImage(size, format));
+        }
+    }
+
+    return QJsonObject{
+        {"iterations", static_cast<qint64>(m_iterations)},
+        {"allocationsCounted", AllocationCounter::supported()},
+        {"target", QJsonObject{{"width", m_settings.width()}, {"height", m_settings.height()}}},
+        {"results", results}
+    };
+}
+
+QJsonObject ImageConvertorBenchmark::runImage(cv::Size const& size, QString const& format)
+{
+    auto const image = makeImage(size);
+
+    std::vector<uchar> buffer;
+    std::vector<int> const params = format == ".jpg"
+            ? std::vector<int>{cv::IMWRITE_JPEG_QUALITY, JPEG_QUALITY}
+            : std::vector<int>{cv::IMWRITE_PNG_COMPRESSION, PNG_COMPRESSION};
+    cv::imencode(format.toStdString(), image, buffer, params);
+    QByteArray const encoded(reinterpret_cast<char const*>(buffer.data()), static_cast<int>(buffer.size()));
+
+    // file for imread path
+    QTemporaryDir dir;
+    auto const path = dir.filePath(QString("image_%1x%2%3").arg(size.width).arg(size.height).arg(format));
+    QFile file(path);
+    if (!file.open(QFile::WriteOnly) || file.write(encoded) != encoded.size())
+    {
+        qCCritical(QLC_IMAGE_CONVERTOR_BENCHMARK) << "Cannot write image:" << path << "error:" << file.errorString();
+    }
+    file.close();
+
+    auto const report = [this] (std::vector<Step> const& steps) {
+        QJsonArray array;
+        for (auto const& step : steps)
+        {
+            array.append(QJsonObject{
+                             {"step", step.name},
+                             {"nsPerImage", static_cast<qint64>(step.nsecs / static_cast<qint64>(m_iterations))},
+                             {"allocationsPerImage", static_cast<double>(step.allocations) / m_iterations}
+                         });
+        }
+        return array;
+    };
+
+    auto const steps = measureSteps(encoded, path);
+
+    // sum of steps of binary request, imread is alternative of imdecode
+    Step sum{"sumOfSteps"};
+    for (size_t i = 0; i < steps.size(); ++i)
+    {
+        if (i != Read)
+        {
+            sum.nsecs += steps[i].nsecs;
+            sum.allocations += steps[i].allocations;
+        }
+    }
+
+    auto pipeline = measurePipeline(encoded, path);
+    pipeline.push_back(sum);
+
+    return QJsonObject{
+        {"width", size.width},
+        {"height", size.height},
+        {"format", format == ".jpg" ? "jpeg" : "png"},
+        {"encodedBytes", encoded.size()},
+        {"steps", report(steps)},
+        {"pipeline", report(pipeline)}
+    };
+}
+
+std::vector<ImageConvertorBenchmark::Step> ImageConvertorBenchmark::measureSteps(QByteArray const& encoded, QString const& path) const
+{
+    std::vector<Step> steps(StepsCount);
+    steps[Decode].name = "imdecode";
+    steps[Read].name = "imread";
+    steps[Crop].name = "crop";
+    steps[Resize].name = "resize";
+    steps[Split].name = "split";
+    steps[ConvertTo].name = "convertTo";
+    steps[DivideScale].name = "divideScale";
+    steps[SubtractMean].name = "subtractMean";
+    steps[DivideStd].name = "divideStd";
+
+    auto const file = path.toStdString();
+    cv::Size const target(m_settings.width(), m_settings.height());
+
+    // same operations as ImageConvertor::prepare
+    for (size_t i = 0; i < WARMUP_ITERATIONS + m_iterations; ++i)
+    {
+        auto const measured = i >= WARMUP_ITERATIONS;
+
+        cv::Mat source;
+        measure(steps[Decode], measured, [&] {
+            source = cv::imdecode(cv::_InputArray(encoded.data(), encoded.size()), cv::IMREAD_COLOR);
+        });
+
+        measure(steps[Read], measured, [&] {
+            cv::imread(file);
+        });
+
+        measure(steps[Crop], measured, [&] {
+            auto crop = image::opencv::getAutoCropSize(source.size(), target);
+            crop.height = static_cast<int>(crop.height / m_settings.zoom());
+            crop.width = static_cast<int>(crop.width / m_settings.zoom());
+
+            cv::Rect const roi((source.size().width - crop.width) / 2, (source.size().height - crop.height) / 2,
+                               crop.width, crop.height);
+            source = source(roi);
+        });
+
+        measure(steps[Resize], measured, [&] {
+            cv::resize(source, source, target);
+        });
+
+        std::vector<cv::Mat> channels;
+        measure(steps[Split], measured, [&] {
+            cv::split(source, channels);
+        });
+
+        measure(steps[ConvertTo], measured, [&] {
+            for (auto& channel : channels)
+            {
+                channel.convertTo(channel, CV_32FC1);
+            }
+        });
+
+        measure(steps[DivideScale], measured, [&] {
+            for (auto& channel : channels)
+            {
+                channel /= 255;
+            }
+        });
+
+        measure(steps[SubtractMean], measured, [&] {
+            for (size_t ch = 0; ch < channels.size(); ++ch)
+            {
+                channels[ch] -= m_settings.mean()[static_cast<int>(ch)];
+            }
+        });
+
+        measure(steps[DivideStd], measured, [&] {
+            for (size_t ch = 0; ch < channels.size(); ++ch)
+            {
+                channels[ch] /= m_settings.std()[static_cast<int>(ch)];
+            }
+        });
+    }
+
+    return steps;
+}
+
+std::vector<ImageConvertorBenchmark::Step> ImageConvertorBenchmark::measurePipeline(QByteArray const& encoded, QString const& path) const
+{
+    std::vector<Step> steps = {{"convertBinary"}, {"convertPath"}};
+
+    for (size_t i = 0; i < WARMUP_ITERATIONS + m_iterations; ++i)
+    {
+        auto const measured = i >= WARMUP_ITERATIONS;
+
+        measure(steps[0], measured, [&] {
+            m_convertor.convert(encoded);
+        });
+
+        measure(steps[1], measured, [&] {
+            m_convertor.convert(path);
+        });
+    }
+
+    return steps;
+}
+
+cv::Mat ImageConvertorBenchmark::makeImage(cv::Size const& size)
+{
+    // smooth gradients with mild noise are compressed like photos, unlike pure noise
+    cv::Mat image(size, CV_8UC3);
+    for (int y = 0; y < size.height; ++y)
+    {
+        auto const row = image.ptr<cv::Vec3b>(y);
+        for (int x = 0; x < size.width; ++x)
+        {
+            row[x] = cv::Vec3b(static_cast<uchar>(x * 255 / size.width),
+                               static_cast<uchar>(y * 255 / size.height),
+                               static_cast<uchar>((x + y) / 8));
+        }
+    }
+
+    cv::Mat noise(size, CV_8UC3);
+    cv::RNG rng(NOISE_SEED);
+    rng.fill(noise, cv::RNG::UNIFORM, 0, 16);
+    cv::add(image, noise, image);
+
+    return image;
+}
+}
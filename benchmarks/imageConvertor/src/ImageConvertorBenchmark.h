@@ -0,0 +1,84 @@
+#pragma once
+
+#include <QJsonObject>
+#include <QByteArray>
+#include <QString>
+#include <QList>
+
+#include <opencv2/core/mat.hpp>
+
+#include "image/opencv/ImageConvertor.h"
+
+
+namespace benchmark
+{
+/**
+ * @brief The ImageConvertorBenchmark class - cost of each step of image::opencv::ImageConvertor
+ * and of whole pipeline for synthetic JPEG and PNG images of different resolutions,
+ * reported as nanoseconds and heap allocations per image
+ */
+class ImageConvertorBenchmark
+{
+public:
+    /**
+     * @param settings - settings of image convertor, valid
+     * @param iterations - count of measured iterations per image
+     */
+    ImageConvertorBenchmark(image::ImageConvertorSettings const& settings, size_t iterations);
+
+    /**
+     * @brief run benchmark for all resolutions and formats
+     * @param resolutions - sizes of source images
+     * @return report
+     */
+    QJsonObject run(QList<cv::Size> const& resolutions);
+
+private:
+    /**
+     * Time and allocations accumulated by step
+     */
+    struct Step
+    {
+        char const* name = nullptr;
+        qint64 nsecs = 0;
+        quint64 allocations = 0;
+    };
+
+private:
+    /**
+     * @brief measure image encoded in format
+     * @param size - size of source image
+     * @param format - extension of format (".jpg", ".png")
+     * @return report
+     */
+    QJsonObject runImage(cv::Size const& size, QString const& format);
+
+    /**
+     * @brief measure each step of preparing separately
+     * @param encoded - binary data of image
+     * @param path - path to image
+     * @return steps
+     */
+    std::vector<Step> measureSteps(QByteArray const& encoded, QString const& path) const;
+
+    /**
+     * @brief measure whole pipeline of image convertor
+     * @param encoded - binary data of image
+     * @param path - path to image
+     * @return steps
+     */
+    std::vector<Step> measurePipeline(QByteArray const& encoded, QString const& path) const;
+
+    /**
+     * @brief synthetic image with gradients and noise, deterministic
+     * @param size
+     * @return image
+     */
+    static cv::Mat makeImage(cv::Size const& size);
+
+private:
+    image::ImageConvertorSettings m_settings{};
+    image::opencv::ImageConvertor m_convertor{};
+    size_t m_iterations = 0;
+};
+}
@@ -0,0 +1,106 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QLoggingCategory>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+#include <QFile>
+
+#include "ImageConvertorBenchmark.h"
+
+
+Q_LOGGING_CATEGORY(QLC_BENCHMARK, "Benchmark")
+
+static constexpr int CHANNELS = 3;
+static constexpr auto DEFAULT_RESOLUTIONS = "640x480,1280x960,1920x1080,3840x2160,6000x4000";
+
+static bool parseResolutions(QString const& value, QList<cv::Size>& resolutions)
+{
+    for (auto const& resolution : value.split(','))
+    {
+        auto const sides = resolution.trimmed().split('x');
+        bool widthOk = false;
+        bool heightOk = false;
+        auto const width = sides.value(0).toInt(&widthOk);
+        auto const height = sides.value(1).toInt(&heightOk);
+        if (sides.size() != 2 || !widthOk || !heightOk || width <= 0 || height <= 0)
+        {
+            qCCritical(QLC_BENCHMARK) << "Invalid resolution:" << resolution;
+            return false;
+        }
+        resolutions.append(cv::Size(width, height));
+    }
+
+    return true;
+}
+
+static bool readSettings(QString const& path, image::ImageConvertorSettings& settings)
+{
+    QFile file(path);
+    if (!file.open(QFile::ReadOnly | QFile::Text))
+    {
+        qCCritical(QLC_BENCHMARK) << "Cannot open settings:" << path << "error:" << file.errorString();
+        return false;
+    }
+
+    auto const json = QJsonDocument::fromJson(file.readAll()).object();
+    return settings.parse(json.value("image").toObject());
+}
+
+int main(int argn, char* argv[])
+{
+    qSetMessagePattern("%{time hh:mm::ss.zzz} [%{type}] %{category}: %{message}");
+    // debug logs of convertor would be measured with each image
+    QLoggingCategory::setFilterRules("*.debug=false");
+
+    QCoreApplication app(argn, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Microbenchmark of image convertor steps");
+    parser.addHelpOption();
+
+    QCommandLineOption const settingsOption("settings", "Path to settings with image section.", "path", "settings.json");
+    QCommandLineOption const widthOption("width", "Width of input of network.", "px", "224");
+    QCommandLineOption const heightOption("height", "Height of input of network.", "px", "224");
+    QCommandLineOption const iterationsOption("iterations", "Count of measured iterations per image.", "n", "20");
+    QCommandLineOption const resolutionsOption("resolutions", "Source resolutions.", "list", DEFAULT_RESOLUTIONS);
+    QCommandLineOption const outputOption("output", "Path to JSON report (default - stdout).", "path");
+    parser.addOptions({settingsOption, widthOption, heightOption, iterationsOption, resolutionsOption, outputOption});
+    parser.process(app);
+
+    image::ImageConvertorSettings settings;
+    if (!readSettings(parser.value(settingsOption), settings))
+    {
+        return 1;
+    }
+    settings.setWidth(parser.value(widthOption).toInt());
+    settings.setHeight(parser.value(heightOption).toInt());
+    settings.setChannels(CHANNELS);
+
+    QList<cv::Size> resolutions;
+    auto const iterations = parser.value(iterationsOption).toInt();
+    if (!settings.valid() || iterations <= 0 || !parseResolutions(parser.value(resolutionsOption), resolutions))
+    {
+        qCCritical(QLC_BENCHMARK) << "Invalid options, see --help";
+        return 1;
+    }
+
+    benchmark::ImageConvertorBenchmark benchmark(settings, static_cast<size_t>(iterations));
+    auto const report = QJsonDocument(benchmark.run(resolutions)).toJson(QJsonDocument::Indented);
+
+    if (!parser.isSet(outputOption))
+    {
+        QTextStream(stdout) << report;
+        return 0;
+    }
+
+    QFile file(parser.value(outputOption));
+    if (!file.open(QFile::WriteOnly | QFile::Truncate) || file.write(report) != report.size())
+    {
+        qCCritical(QLC_BENCHMARK) << "Cannot write report:" << file.fileName() << "error:" << file.errorString();
+        return 1;
+    }
+
+    qCInfo(QLC_BENCHMARK) << "Report is written to" << file.fileName();
+    return 0;
+}
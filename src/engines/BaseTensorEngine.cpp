@@ -1,13 +1,29 @@
 #include "BaseTensorEngine.h"
+#include "utils/ThreadAffinity.h"
 
 #include <QLoggingCategory>
-#include <QElapsedTimer>
+
+#include <algorithm>
 
 
 namespace engines
 {
 Q_LOGGING_CATEGORY(QLC_BASE_TENSOR_ENGINE, "BaseTensorEngine")
 
+BaseTensorEngine::~BaseTensorEngine()
+{
+    {
+        std::unique_lock<std::mutex> lock(m_inferMutex);
+        m_exit = true;
+    }
+    m_inferNotifier.notify_all();
+
+    if (m_inferThread.joinable())
+    {
+        m_inferThread.join();
+    }
+}
+
 BaseTensorEngineSettings const& BaseTensorEngine::settings() const
 {
     return m_settings;
@@ -27,33 +43,64 @@ qint64 BaseTensorEngine::estimate()
         return -1;
     };
 
-    QElapsedTimer timer;
-    std::vector<float> const dummyInput(maxBatches() * batchInputN());
+    std::vector<float> const dummyInput(batchInputN());
     std::vector<float> dummyOutput(maxBatches() * batchOutputN());
 
-    timer.start();
+    // index is batch size, zero is unused
+    std::vector<qint64> batchCosts(maxBatches() + 1, -1);
+    for (size_t batches = 1; batches <= maxBatches(); ++batches)
+    {
+        batchCosts[batches] = estimateBatches(batches, dummyInput, dummyOutput);
+        if (batchCosts[batches] < 0)
+        {
+            return estimateFailed();
+        }
+
+        qCDebug(QLC_BASE_TENSOR_ENGINE) << "Estimate infer of" << batches << "batches:" << batchCosts[batches] << "nanoseconds";
+    }
+
+    m_batchCosts = std::move(batchCosts);
+
+    // throughput of full batch, compared between engines and their settings
+    qCInfo(QLC_BASE_TENSOR_ENGINE) << "Estimate infer throughput:"
+                                   << maxBatches() * 1e9 / std::max<qint64>(m_batchCosts[maxBatches()], 1)
+                                   << "inputs per second";
+
+    return estimateSuccess(m_batchCosts[maxBatches()]);
+}
+
+std::vector<qint64> const& BaseTensorEngine::batchCosts() const
+{
+    return m_batchCosts;
+}
+
+qint64 BaseTensorEngine::estimateBatches(size_t batches, std::vector<float> const& dummyInput, std::vector<float>& dummyOutput)
+{
+    // only forward is summed, as recorded by workers for each batch
+    qint64 elapsed = 0;
     for (size_t i = 0; i < settings().countTestsForEstimate(); ++i)
     {
-        for (size_t b = 0; b < maxBatches(); ++b)
+        for (size_t b = 0; b < batches; ++b)
         {
             if(!loadToInput(b, 0, dummyInput.data(), batchInputN()))
             {
-                return estimateFailed();
+                return -1;
             }
         }
 
-        if(!infer(maxBatches()))
+        if(!infer(batches))
         {
-            return estimateFailed();
+            return -1;
         }
+        elapsed += lastInferNs();
 
-        if(!unloadOutput(maxBatches(), dummyOutput.data()))
+        if(!unloadOutput(batches, dummyOutput.data()))
         {
-            return estimateFailed();
+            return -1;
         }
     }
 
-    return estimateSuccess(timer.nsecsElapsed() / settings().countTestsForEstimate());
+    return elapsed / static_cast<qint64>(settings().countTestsForEstimate());
 }
 
 bool BaseTensorEngine::load(BaseTensorEngineSettings const& settings)
@@ -66,7 +113,11 @@ bool BaseTensorEngine::load(BaseTensorEngineSettings const& settings)
 
     m_settings = settings;
 
-    loadImpl(settings);
+    if (!loadImpl(settings))
+    {
+        qCCritical(QLC_BASE_TENSOR_ENGINE) << "Cannot load tensor engine";
+        return false;
+    }
 
     if (m_settings.positiveIndex() >= outputSize() || m_settings.negativeIndex() >= outputSize())
     {
@@ -87,6 +138,92 @@ size_t BaseTensorEngine::negativeIndex() const
     return settings().negativeIndex();
 }
 
+void BaseTensorEngine::prepareThread(size_t maxThreads, std::vector<int> const& cpus)
+{
+    post([this, maxThreads, cpus] {
+        utils::ThreadAffinity::pinCurrentThread(cpus);
+        prepareThreadImpl(maxThreads, cpus);
+        return true;
+    });
+    waitInfer();
+}
+
+bool BaseTensorEngine::infer(size_t batches)
+{
+    return inferAsync(batches) && waitInfer();
+}
+
+bool BaseTensorEngine::inferAsync(size_t batches)
+{
+    if (!validateInfer(batches))
+    {
+        return false;
+    }
+    if (m_jobInProgress)
+    {
+        qCCritical(QLC_BASE_TENSOR_ENGINE) << "Previous infer is not waited";
+        return false;
+    }
+
+    auto const buffer = m_stagingBuffer;
+    m_stagingBuffer = (m_stagingBuffer + 1) % INPUT_BUFFERS;
+
+    post([this, buffer, batches] {
+        auto const start = Clock::now();
+        auto const result = inferImpl(buffer, batches);
+        m_lastInferEnd = Clock::now();
+        m_lastInferNs = std::chrono::duration_cast<std::chrono::nanoseconds>(m_lastInferEnd - start).count();
+        return result;
+    });
+
+    return true;
+}
+
+bool BaseTensorEngine::waitInfer()
+{
+    if (!m_jobInProgress)
+    {
+        qCCritical(QLC_BASE_TENSOR_ENGINE) << "Infer is not started";
+        return false;
+    }
+
+    std::unique_lock<std::mutex> lock(m_inferMutex);
+    m_inferNotifier.wait(lock, [this] { return m_jobDone; });
+    m_jobInProgress = false;
+
+    return m_jobResult;
+}
+
+qint64 BaseTensorEngine::lastInferNs() const
+{
+    return m_lastInferNs;
+}
+
+ITensorEngine::Clock::time_point BaseTensorEngine::lastInferEnd() const
+{
+    return m_lastInferEnd;
+}
+
+void BaseTensorEngine::setInferDoneCallback(std::function<void()> const& callback)
+{
+    std::unique_lock<std::mutex> lock(m_inferMutex);
+    m_inferDoneCallback = callback;
+}
+
+void BaseTensorEngine::prepareThreadImpl(size_t, std::vector<int> const&)
+{
+}
+
+std::shared_ptr<void> BaseTensorEngine::createInferThreadContext()
+{
+    return nullptr;
+}
+
+size_t BaseTensorEngine::stagingBuffer() const
+{
+    return m_stagingBuffer;
+}
+
 bool BaseTensorEngine::loadImpl(BaseTensorEngineSettings const&)
 {
     return false;
@@ -155,4 +292,58 @@ bool BaseTensorEngine::validateInfer(size_t batches) const
 
     return true;
 }
+
+void BaseTensorEngine::post(std::function<bool()> const& job)
+{
+    {
+        std::unique_lock<std::mutex> lock(m_inferMutex);
+        if (!m_inferThread.joinable())
+        {
+            m_inferThread = std::thread([this] { runInferThread(); });
+        }
+
+        m_job = job;
+        m_jobDone = false;
+        m_jobInProgress = true;
+    }
+    m_inferNotifier.notify_all();
+}
+
+void BaseTensorEngine::runInferThread()
+{
+    auto const context = createInferThreadContext();
+
+    while (true)
+    {
+        std::function<bool()> job;
+        std::function<void()> done;
+        {
+            std::unique_lock<std::mutex> lock(m_inferMutex);
+            m_inferNotifier.wait(lock, [this] { return m_exit || m_job; });
+
+            if (!m_job)
+            {
+                return;
+            }
+
+            job = std::move(m_job);
+            m_job = nullptr;
+            done = m_inferDoneCallback;
+        }
+
+        bool const result = job();
+
+        {
+            std::unique_lock<std::mutex> lock(m_inferMutex);
+            m_jobResult = result;
+            m_jobDone = true;
+        }
+        m_inferNotifier.notify_all();
+
+        if (done)
+        {
+            done();
+        }
+    }
+}
 }
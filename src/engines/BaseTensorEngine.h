@@ -3,6 +3,13 @@
 #include "engines/ITensorEngine.h"
 #include "engines/BaseTensorEngineSettings.h"
 
+#include <functional>
+#include <memory>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
 
 namespace engines
 {
@@ -13,6 +20,7 @@ class BaseTensorEngine : public engines::ITensorEngine
 {
 public:
     BaseTensorEngine() = default;
+    ~BaseTensorEngine() override;
 
     BaseTensorEngineSettings const& settings() const;
 
@@ -21,17 +29,79 @@ public: // IEstimated interface
 
 public: // ITensorEngine interface
     bool load(BaseTensorEngineSettings const& settings) override;
+    std::vector<qint64> const& batchCosts() const override;
     size_t positiveIndex() const override;
     size_t negativeIndex() const override;
+    void prepareThread(size_t maxThreads, std::vector<int> const& cpus) override;
+    bool infer(size_t batches) override;
+    bool inferAsync(size_t batches) override;
+    bool waitInfer() override;
+    qint64 lastInferNs() const override;
+    Clock::time_point lastInferEnd() const override;
+    void setInferDoneCallback(std::function<void()> const& callback) override;
 
 protected:
+    /**
+     * Count of input buffers, one is forwarded while other is loaded
+     */
+    static constexpr size_t INPUT_BUFFERS = 2;
+
     virtual bool loadImpl(BaseTensorEngineSettings const& settings);
 
+    /**
+     * @brief forward input buffer, called from infer thread
+     * @param buffer - index of input buffer
+     * @param batches - count batches for forward
+     * @return bool - success
+     */
+    virtual bool inferImpl(size_t buffer, size_t batches) = 0;
+
+    /**
+     * @brief prepare infer thread, called from infer thread after pinning
+     * @param maxThreads - threads budget for forward (0 - engine default)
+     * @param cpus - cpus for pinning forward threads (empty - not pinned)
+     */
+    virtual void prepareThreadImpl(size_t maxThreads, std::vector<int> const& cpus);
+
+    /**
+     * @brief create context of infer thread, called from infer thread when it starts
+     * context is held till exit of infer thread, so thread local guards of framework cover all forwards
+     * @return context (nullptr - no context)
+     */
+    virtual std::shared_ptr<void> createInferThreadContext();
+
+    /**
+     * @brief index of input buffer for loading
+     * @return index
+     */
+    size_t stagingBuffer() const;
+
     bool validateLoadInput(size_t batch, size_t offset, Tensor const* src, size_t n) const;
     bool validateLoadOutput(size_t batches, Tensor* dst) const;
     bool validateInfer(size_t batches) const;
 
+private:
+    qint64 estimateBatches(size_t batches, std::vector<float> const& dummyInput, std::vector<float>& dummyOutput);
+    void post(std::function<bool()> const& job);
+    void runInferThread();
+
 private:
     BaseTensorEngineSettings m_settings{};
+    size_t m_stagingBuffer = 0;
+    std::vector<qint64> m_batchCosts{};
+
+    // written by infer thread, read after waitInfer
+    qint64 m_lastInferNs = 0;
+    Clock::time_point m_lastInferEnd{};
+    std::function<void()> m_inferDoneCallback{};
+
+    std::thread m_inferThread{};
+    std::mutex m_inferMutex{};
+    std::condition_variable m_inferNotifier{};
+    std::function<bool()> m_job{};
+    bool m_jobInProgress = false;
+    bool m_jobDone = false;
+    bool m_jobResult = false;
+    bool m_exit = false;
 };
 }
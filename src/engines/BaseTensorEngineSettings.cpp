@@ -51,6 +51,14 @@ public:
                 return false;
             }
         }
+        JSON_HELPER.get(json, "maxBatchWaitUs", m_maxBatchWaitUs, false);
+        JSON_HELPER.get(json, "targetBatchFill", m_targetBatchFill, false);
+        JSON_HELPER.get(json, "latencyBudgetUs", m_latencyBudgetUs, false);
+        JSON_HELPER.get(json, "queueCapacity", m_queueCapacity, false);
+        JSON_HELPER.get(json, "replicas", m_replicas, false);
+        JSON_HELPER.get(json, "threadsPerReplica", m_threadsPerReplica, false);
+        JSON_HELPER.getArray(json, "replicasCpus", m_replicasCpus, false);
+
         return JSON_HELPER.get(json, "maxBatches", m_maxBatches, true)
                 && JSON_HELPER.get(json, "positiveIndex", m_positiveIndex, true)
                 && JSON_HELPER.get(json, "negativeIndex", m_negativeIndex, true)
@@ -66,7 +74,12 @@ public:
                 && countTestsForEstimate() > 0
                 && positiveIndex() >= 0
                 && negativeIndex() >= 0
-                && positiveIndex() != negativeIndex();
+                && positiveIndex() != negativeIndex()
+                && maxBatchWaitUs() >= 0
+                && targetBatchFill() > 0 && targetBatchFill() <= 1
+                && latencyBudgetUs() >= 0
+                && queueCapacity() >= maxBatches()
+                && replicas() > 0;
     }
 
     QString const& type() const override
@@ -94,12 +107,54 @@ public:
         return m_negativeIndex;
     }
 
+    int maxBatchWaitUs() const override
+    {
+        return m_maxBatchWaitUs;
+    }
+
+    float targetBatchFill() const override
+    {
+        return m_targetBatchFill;
+    }
+
+    int latencyBudgetUs() const override
+    {
+        return m_latencyBudgetUs;
+    }
+
+    size_t queueCapacity() const override
+    {
+        return m_queueCapacity;
+    }
+
+    size_t replicas() const override
+    {
+        return m_replicas;
+    }
+
+    size_t threadsPerReplica() const override
+    {
+        return m_threadsPerReplica;
+    }
+
+    QStringList const& replicasCpus() const override
+    {
+        return m_replicasCpus;
+    }
+
 private:
     QString m_type{};
     size_t m_maxBatches = 0;
     size_t m_countTestsForEstimate = 0;
     size_t m_positiveIndex = 0;
     size_t m_negativeIndex = 0;
+    int m_maxBatchWaitUs = 0;
+    float m_targetBatchFill = 1;
+    int m_latencyBudgetUs = 0;
+    size_t m_queueCapacity = 1024;
+    size_t m_replicas = 1;
+    size_t m_threadsPerReplica = 0;
+    QStringList m_replicasCpus{};
 };
 
 void BaseTensorEngineSettings::registerType(QString const& type, TypeConstructor const& constructor)
@@ -145,6 +200,41 @@ size_t BaseTensorEngineSettings::negativeIndex() const
     return m_instance->negativeIndex();
 }
 
+int BaseTensorEngineSettings::maxBatchWaitUs() const
+{
+    return m_instance->maxBatchWaitUs();
+}
+
+float BaseTensorEngineSettings::targetBatchFill() const
+{
+    return m_instance->targetBatchFill();
+}
+
+int BaseTensorEngineSettings::latencyBudgetUs() const
+{
+    return m_instance->latencyBudgetUs();
+}
+
+size_t BaseTensorEngineSettings::queueCapacity() const
+{
+    return m_instance->queueCapacity();
+}
+
+size_t BaseTensorEngineSettings::replicas() const
+{
+    return m_instance->replicas();
+}
+
+size_t BaseTensorEngineSettings::threadsPerReplica() const
+{
+    return m_instance->threadsPerReplica();
+}
+
+QStringList const& BaseTensorEngineSettings::replicasCpus() const
+{
+    return m_instance->replicasCpus();
+}
+
 bool BaseTensorEngineSettings::parse(QJsonObject const& json)
 {
     if (m_instance.get() == nullptr)
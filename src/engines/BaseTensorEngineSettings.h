@@ -5,6 +5,7 @@
 #include <memory>
 
 #include <QMap>
+#include <QStringList>
 
 #include "common/ISettings.h"
 
@@ -63,6 +64,54 @@ public:
      */
     virtual size_t negativeIndex() const;
 
+    /**
+     * @brief max time in microseconds for holding partial batch
+     * while waiting more requests (0 - batch is forwarded immediately)
+     * @return microseconds
+     */
+    virtual int maxBatchWaitUs() const;
+
+    /**
+     * @brief target fill of batch (part of max batches in range (0, 1])
+     * partial batch less than target can be held up to max batch wait
+     * @return fill
+     */
+    virtual float targetBatchFill() const;
+
+    /**
+     * @brief latency budget in microseconds for one request in tensor engine queue
+     * partial batch is not held if it breaks budget (0 - unlimited)
+     * @return microseconds
+     */
+    virtual int latencyBudgetUs() const;
+
+    /**
+     * @brief capacity of requests queue to tensor engine
+     * @return count
+     */
+    virtual size_t queueCapacity() const;
+
+    /**
+     * @brief count of tensor engine replicas, each in own worker thread
+     * @return count
+     */
+    virtual size_t replicas() const;
+
+    /**
+     * @brief threads budget for forward of one replica
+     * if zero will be equal hardware value divided by replicas
+     * @return count
+     */
+    virtual size_t threadsPerReplica() const;
+
+    /**
+     * @brief cpus for pinning of each replica (worker, infer and intra-op threads),
+     * replica is pinned by index modulo count (empty - not pinned)
+     * each item is list of cpus and ranges ("0-7,16") or NUMA node ("node:0")
+     * @return cpus
+     */
+    virtual QStringList const& replicasCpus() const;
+
     /**
      * @brief cast object to child instance
      */
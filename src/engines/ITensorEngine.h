@@ -2,8 +2,11 @@
 
 #include <QtGlobal>
 
+#include <chrono>
 #include <memory>
+#include <vector>
 #include <cstdint>
+#include <functional>
 
 #include "common/IEstimated.h"
 #include "BaseTensorEngineSettings.h"
@@ -22,6 +25,11 @@ public:
      */
     using Tensor = float;
 
+    /**
+     * Clock of forward timestamps
+     */
+    using Clock = std::chrono::steady_clock;
+
     virtual ~ITensorEngine() { }
 
     /**
@@ -36,6 +44,12 @@ public:
      */
     virtual size_t maxBatches() const = 0;
 
+    /**
+     * @brief cost of forward of each batch size measured by estimate
+     * @return nanoseconds indexed by batch size from 1 to maxBatches (empty if not estimated)
+     */
+    virtual std::vector<qint64> const& batchCosts() const = 0;
+
     /**
      * @brief input width data
      * @return size_t
@@ -84,6 +98,13 @@ public:
      */
     virtual size_t negativeIndex() const = 0;
 
+    /**
+     * @brief prepare thread which runs forward
+     * @param maxThreads - threads budget for forward (0 - engine default)
+     * @param cpus - cpus for pinning forward threads (empty - not pinned)
+     */
+    virtual void prepareThread(size_t maxThreads, std::vector<int> const& cpus) = 0;
+
     /**
      * @brief load to tnput data to device
      * @param batch - number of batch
@@ -108,6 +129,42 @@ public:
      * @return bool - success
      */
     virtual bool infer(size_t batches) = 0;
+
+    /**
+     * @brief start forward of loaded data without waiting
+     * next loadToInput writes to another input buffer,
+     * so next batches can be loaded while forward in progress
+     * @param batches - count batches for forward
+     * @return bool - success of start
+     */
+    virtual bool inferAsync(size_t batches) = 0;
+
+    /**
+     * @brief wait forward started by inferAsync, after that output can be unloaded
+     * @return bool - success of forward
+     */
+    virtual bool waitInfer() = 0;
+
+    /**
+     * @brief duration of last forward, measured on infer thread around forward only,
+     * so it excludes waiting and loading of next batch by caller
+     * @return nanoseconds (valid after waitInfer)
+     */
+    virtual qint64 lastInferNs() const = 0;
+
+    /**
+     * @brief time when last forward finished
+     * @return time point (valid after waitInfer)
+     */
+    virtual Clock::time_point lastInferEnd() const = 0;
+
+    /**
+     * @brief set callback of finished forward, called from infer thread,
+     * so caller can wake up when forward started by inferAsync is done
+     * @warning should be set before inferAsync
+     * @param callback (empty - no callback)
+     */
+    virtual void setInferDoneCallback(std::function<void()> const& callback) = 0;
 };
 
 using ITensorEnginePtr = std::shared_ptr<ITensorEngine>;
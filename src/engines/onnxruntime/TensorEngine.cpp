@@ -0,0 +1,311 @@
+#include "TensorEngine.h"
+
+#include <QLoggingCategory>
+#include <QFile>
+
+#include <algorithm>
+
+
+namespace engines
+{
+namespace onnxruntime
+{
+Q_LOGGING_CATEGORY(QLC_ONNX_RUNTIME, "OnnxRuntimeEngine")
+
+static constexpr auto LOG_ID = "SkinCancerDetector";
+
+/**
+ * @brief environment of ONNX Runtime, one per process
+ * @return
+ */
+static Ort::Env& env()
+{
+    static Ort::Env env(ORT_LOGGING_LEVEL_WARNING, LOG_ID);
+    return env;
+}
+
+static GraphOptimizationLevel graphOptimizationLevel(QString const& level)
+{
+    if (level == "disable")
+    {
+        return ORT_DISABLE_ALL;
+    }
+    if (level == "basic")
+    {
+        return ORT_ENABLE_BASIC;
+    }
+    if (level == "extended")
+    {
+        return ORT_ENABLE_EXTENDED;
+    }
+
+    return ORT_ENABLE_ALL;
+}
+
+bool TensorEngine::loadImpl(BaseTensorEngineSettings const& settings)
+{
+    auto const& onnxRuntimeSettings = settings.toInstance<onnxruntime::TensorEngineSettings>();
+
+    if (!onnxRuntimeSettings)
+    {
+        qCCritical(QLC_ONNX_RUNTIME) << "Invalid setting for load onnx runtime tensor engine";
+        return false;
+    }
+    m_settings = onnxRuntimeSettings;
+
+    m_session = createSession(static_cast<size_t>(m_settings->intraOpThreads()));
+    if (!m_session)
+    {
+        return false;
+    }
+
+    qCInfo(QLC_ONNX_RUNTIME) << "Model" << m_settings->modelPath() << "loaded";
+    return true;
+}
+
+size_t TensorEngine::maxBatches() const
+{
+    return m_session->maxBatches;
+}
+
+size_t TensorEngine::inputWidth() const
+{
+    return static_cast<size_t>(m_session->inputShape[3]);
+}
+
+size_t TensorEngine::inputHeight() const
+{
+    return static_cast<size_t>(m_session->inputShape[2]);
+}
+
+size_t TensorEngine::inputChannels() const
+{
+    return static_cast<size_t>(m_session->inputShape[1]);
+}
+
+size_t TensorEngine::outputSize() const
+{
+    return static_cast<size_t>(m_session->outputShape[1]);
+}
+
+bool TensorEngine::loadToInput(size_t batch, size_t offset, Tensor const* src, size_t n)
+{
+    if (!validateLoadInput(batch, offset, src, n))
+    {
+        return false;
+    }
+
+    auto const input = m_session->inputs[stagingBuffer()].GetTensorMutableData<Tensor>() + batch * batchInputN() + offset;
+    std::copy(src, src + n, input);
+
+    return true;
+}
+
+bool TensorEngine::unloadOutput(size_t batches, Tensor* dst)
+{
+    if (!validateLoadOutput(batches, dst))
+    {
+        return false;
+    }
+
+    auto const src = m_session->output.GetTensorMutableData<Tensor>();
+    std::copy(src, src + batches * batchOutputN(), dst);
+
+    return true;
+}
+
+bool TensorEngine::inferImpl(size_t buffer, size_t batches)
+{
+    if (batches == 0)
+    {
+        return false;
+    }
+    if (!m_session)
+    {
+        qCCritical(QLC_ONNX_RUNTIME) << "Session is not created";
+        return false;
+    }
+
+    try
+    {
+        qCDebug(QLC_ONNX_RUNTIME) << "Starting infer batches" << batches;
+        m_session->session->Run(Ort::RunOptions{nullptr}, *m_session->bindings[buffer][batches - 1].ioBinding);
+    }
+    catch (std::exception const& ex)
+    {
+        qCCritical(QLC_ONNX_RUNTIME) << "Forward failed, reason:" << ex.what();
+        return false;
+    }
+
+    qCDebug(QLC_ONNX_RUNTIME) << "Infer batches" << batches << "completed";
+
+    return true;
+}
+
+void TensorEngine::prepareThreadImpl(size_t maxThreads, std::vector<int> const& cpus)
+{
+    if (m_settings->intraOpThreads() > 0 || (maxThreads == 0 && cpus.empty()))
+    {
+        return;
+    }
+
+    // thread pools of session are fixed on creation, so session is recreated with threads budget of replica,
+    // its threads inherit affinity of pinned infer thread
+    // previous session is kept if new one cannot be created or differs by max batches
+    auto session = createSession(maxThreads);
+    if (!session)
+    {
+        qCWarning(QLC_ONNX_RUNTIME) << "Cannot recreate session with intra-op threads:" << maxThreads << "previous session is kept";
+        return;
+    }
+    if (m_session && session->maxBatches != m_session->maxBatches)
+    {
+        qCWarning(QLC_ONNX_RUNTIME) << "Recreated session has other max batches:" << session->maxBatches << "previous session is kept";
+        return;
+    }
+
+    m_session = std::move(session);
+    qCInfo(QLC_ONNX_RUNTIME) << "Session recreated with intra-op threads:" << maxThreads;
+}
+
+size_t TensorEngine::batchInputN() const
+{
+    return m_session->batchInputN;
+}
+
+size_t TensorEngine::batchOutputN() const
+{
+    return m_session->batchOutputN;
+}
+
+std::unique_ptr<TensorEngine::Session> TensorEngine::createSession(size_t intraOpThreads) const
+{
+    auto session = std::make_unique<Session>();
+
+    try
+    {
+        Ort::SessionOptions options;
+        options.SetGraphOptimizationLevel(graphOptimizationLevel(m_settings->graphOptimizationLevel()));
+        options.SetExecutionMode(m_settings->parallelExecution() ? ExecutionMode::ORT_PARALLEL : ExecutionMode::ORT_SEQUENTIAL);
+        if (intraOpThreads > 0)
+        {
+            options.SetIntraOpNumThreads(static_cast<int>(intraOpThreads));
+        }
+        if (m_settings->interOpThreads() > 0)
+        {
+            options.SetInterOpNumThreads(m_settings->interOpThreads());
+        }
+
+        session->session = std::make_unique<Ort::Session>(env(), QFile::encodeName(m_settings->modelPath()).constData(), options);
+
+        if (!readShapes(*session))
+        {
+            return nullptr;
+        }
+
+        createBindings(*session);
+    }
+    catch (std::exception const& ex)
+    {
+        qCCritical(QLC_ONNX_RUNTIME) << "Cannot load model:" << m_settings->modelPath() << "reason:" << ex.what();
+        return nullptr;
+    }
+
+    return session;
+}
+
+bool TensorEngine::readShapes(Session& session) const
+{
+    if (session.session->GetInputCount() != 1 || session.session->GetOutputCount() != 1)
+    {
+        qCCritical(QLC_ONNX_RUNTIME) << "Model should have one input and one output";
+        return false;
+    }
+
+    Ort::AllocatorWithDefaultOptions allocator;
+    session.inputName = session.session->GetInputNameAllocated(0, allocator).get();
+    session.outputName = session.session->GetOutputNameAllocated(0, allocator).get();
+
+    auto const inputInfo = session.session->GetInputTypeInfo(0);
+    auto const outputInfo = session.session->GetOutputTypeInfo(0);
+    session.inputShape = inputInfo.GetTensorTypeAndShapeInfo().GetShape();
+    session.outputShape = outputInfo.GetTensorTypeAndShapeInfo().GetShape();
+
+    auto const fixed = [] (std::vector<int64_t> const& shape) {
+        return std::all_of(shape.begin() + 1, shape.end(), [] (int64_t dim) { return dim > 0; });
+    };
+
+    if (session.inputShape.size() != 4 || session.outputShape.size() != 2 || !fixed(session.inputShape) || !fixed(session.outputShape))
+    {
+        qCCritical(QLC_ONNX_RUNTIME) << "Unsupported shapes of model, expected input [batches, channels, height, width]"
+                                     << "and output [batches, output] with fixed dimensions except batches";
+        return false;
+    }
+
+    // batch dimension is dynamic (negative) or fixed by export
+    session.maxBatches = m_settings->maxBatches();
+    if (session.inputShape[0] > 0 && static_cast<size_t>(session.inputShape[0]) != session.maxBatches)
+    {
+        qCWarning(QLC_ONNX_RUNTIME) << "Model is exported with fixed batches:" << session.inputShape[0]
+                                    << "max batches is changed from" << session.maxBatches;
+        session.maxBatches = static_cast<size_t>(session.inputShape[0]);
+    }
+
+    auto const channels = static_cast<size_t>(session.inputShape[1]);
+    auto const height = static_cast<size_t>(session.inputShape[2]);
+    auto const width = static_cast<size_t>(session.inputShape[3]);
+    session.batchInputN = channels * height * width;
+    session.batchOutputN = static_cast<size_t>(session.outputShape[1]);
+
+    qCInfo(QLC_ONNX_RUNTIME) << "Model input:" << session.inputName.c_str() << "channels:" << channels
+                             << "height:" << height << "width:" << width
+                             << "output:" << session.outputName.c_str() << "size:" << session.batchOutputN;
+    return true;
+}
+
+void TensorEngine::createBindings(Session& session) const
+{
+    Ort::AllocatorWithDefaultOptions allocator;
+    auto const memoryInfo = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+    auto const dynamicBatches = session.inputShape[0] <= 0;
+
+    auto const shape = [] (std::vector<int64_t> shape, size_t batches) {
+        shape[0] = static_cast<int64_t>(batches);
+        return shape;
+    };
+
+    // tensors are allocated by ONNX Runtime once with max batches
+    auto const inputShape = shape(session.inputShape, session.maxBatches);
+    auto const outputShape = shape(session.outputShape, session.maxBatches);
+    for (size_t buffer = 0; buffer < INPUT_BUFFERS; ++buffer)
+    {
+        session.inputs.push_back(Ort::Value::CreateTensor<Tensor>(allocator, inputShape.data(), inputShape.size()));
+    }
+    session.output = Ort::Value::CreateTensor<Tensor>(allocator, outputShape.data(), outputShape.size());
+
+    // each batch size is bound to views of the same tensors, so forward needs no copy
+    for (size_t buffer = 0; buffer < INPUT_BUFFERS; ++buffer)
+    {
+        for (size_t batches = 1; batches <= session.maxBatches; ++batches)
+        {
+            auto const bound = dynamicBatches ? batches : session.maxBatches;
+            auto const boundInputShape = shape(session.inputShape, bound);
+            auto const boundOutputShape = shape(session.outputShape, bound);
+
+            Binding binding;
+            binding.input = Ort::Value::CreateTensor<Tensor>(memoryInfo, session.inputs[buffer].GetTensorMutableData<Tensor>(),
+                                                             bound * session.batchInputN,
+                                                             boundInputShape.data(), boundInputShape.size());
+            binding.output = Ort::Value::CreateTensor<Tensor>(memoryInfo, session.output.GetTensorMutableData<Tensor>(),
+                                                              bound * session.batchOutputN,
+                                                              boundOutputShape.data(), boundOutputShape.size());
+            binding.ioBinding = std::make_unique<Ort::IoBinding>(*session.session);
+            binding.ioBinding->BindInput(session.inputName.c_str(), binding.input);
+            binding.ioBinding->BindOutput(session.outputName.c_str(), binding.output);
+
+            session.bindings[buffer].push_back(std::move(binding));
+        }
+    }
+}
+}
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "engines/BaseTensorEngine.h"
+#include "engines/onnxruntime/TensorEngineSettings.h"
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <onnxruntime_cxx_api.h>
+
+
+namespace engines
+{
+namespace onnxruntime
+{
+/**
+ * @brief The TensorEngine class forward data through Neural Network by ONNX Runtime on CPU
+ * inputs are loaded directly to ONNX Runtime owned tensors, which are bound to session by IoBinding
+ */
+class TensorEngine : public engines::BaseTensorEngine
+{
+public:
+    TensorEngine() = default;
+
+public: // BaseTensorEngine interface
+    bool loadImpl(BaseTensorEngineSettings const& settings) override;
+    bool inferImpl(size_t buffer, size_t batches) override;
+    void prepareThreadImpl(size_t maxThreads, std::vector<int> const& cpus) override;
+
+public: // ITensorEngine interface
+    size_t maxBatches() const override;
+    size_t inputWidth() const override;
+    size_t inputHeight() const override;
+    size_t inputChannels() const override;
+    size_t outputSize() const override;
+    bool loadToInput(size_t batch, size_t offset, Tensor const*src, size_t n) override;
+    bool unloadOutput(size_t batches, Tensor *dst) override;
+    size_t batchInputN() const override;
+    size_t batchOutputN() const override;
+
+private:
+    /**
+     * @brief The Binding struct - views of input and output tensors with batch size bound to session
+     */
+    struct Binding
+    {
+        Ort::Value input{nullptr};
+        Ort::Value output{nullptr};
+        std::unique_ptr<Ort::IoBinding> ioBinding{};
+    };
+
+    /**
+     * @brief The Session struct - session with its shapes, tensors and bindings,
+     * replaced as whole, so failed recreation keeps previous session
+     */
+    struct Session
+    {
+        std::unique_ptr<Ort::Session> session{};
+        std::string inputName{};
+        std::string outputName{};
+
+        // [batches, channels, height, width] and [batches, output]
+        std::vector<int64_t> inputShape{};
+        std::vector<int64_t> outputShape{};
+        size_t maxBatches = 0;
+        size_t batchInputN = 0;
+        size_t batchOutputN = 0;
+
+        // tensors with max batches owned by ONNX Runtime
+        std::vector<Ort::Value> inputs{};
+        Ort::Value output{nullptr};
+
+        // index is batch size - 1
+        std::array<std::vector<Binding>, INPUT_BUFFERS> bindings{};
+    };
+
+private:
+    /**
+     * @brief create session with tensors and bindings
+     * @param intraOpThreads - threads of one operator (0 - ONNX Runtime default)
+     * @return session (nullptr - failed)
+     */
+    std::unique_ptr<Session> createSession(size_t intraOpThreads) const;
+
+    /**
+     * @brief read input and output shapes of model
+     * @param session
+     * @return success
+     */
+    bool readShapes(Session& session) const;
+
+    /**
+     * @brief allocate tensors and bind them for each input buffer and batch size
+     * @param session
+     */
+    void createBindings(Session& session) const;
+
+private:
+    TensorEngineSettings const* m_settings = nullptr;
+    std::unique_ptr<Session> m_session{};
+};
+}
+}
@@ -0,0 +1,64 @@
+#include "TensorEngineSettings.h"
+#include "utils/JsonHelper.h"
+
+#include <QLoggingCategory>
+
+
+namespace engines
+{
+namespace onnxruntime
+{
+Q_LOGGING_CATEGORY(QLC_ONNX_RUNTIME_SETTINGS, "OnnxRuntimeSettings")
+static utils::JsonHelper const JSON_HELPER(QLC_ONNX_RUNTIME_SETTINGS);
+
+static QStringList const GRAPH_OPTIMIZATION_LEVELS = {"disable", "basic", "extended", "all"};
+
+void TensorEngineSettings::registerSelf(QString const& name)
+{
+    registerType<TensorEngineSettings>(name);
+}
+
+QString const& TensorEngineSettings::modelPath() const
+{
+    return m_modelPath;
+}
+
+QString const& TensorEngineSettings::graphOptimizationLevel() const
+{
+    return m_graphOptimizationLevel;
+}
+
+int TensorEngineSettings::intraOpThreads() const
+{
+    return m_intraOpThreads;
+}
+
+int TensorEngineSettings::interOpThreads() const
+{
+    return m_interOpThreads;
+}
+
+bool TensorEngineSettings::parallelExecution() const
+{
+    return m_parallelExecution;
+}
+
+bool TensorEngineSettings::parse(QJsonObject const& json)
+{
+    JSON_HELPER.get(json, "graphOptimizationLevel", m_graphOptimizationLevel, false);
+    JSON_HELPER.get(json, "intraOpThreads", m_intraOpThreads, false);
+    JSON_HELPER.get(json, "interOpThreads", m_interOpThreads, false);
+    JSON_HELPER.get(json, "parallelExecution", m_parallelExecution, false);
+    return JSON_HELPER.get(json, "modelPath", m_modelPath, true);
+}
+
+bool TensorEngineSettings::valid() const
+{
+    return BaseTensorEngineSettings::valid()
+            && !modelPath().isEmpty()
+            && GRAPH_OPTIMIZATION_LEVELS.contains(graphOptimizationLevel())
+            && intraOpThreads() >= 0
+            && interOpThreads() >= 0;
+}
+}
+}
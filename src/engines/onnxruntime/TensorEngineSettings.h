@@ -0,0 +1,66 @@
+#pragma once
+
+#include <QString>
+
+#include "engines/BaseTensorEngineSettings.h"
+
+
+namespace engines
+{
+namespace onnxruntime
+{
+/**
+ * @brief The TensorEngineSettings class contains setting for build ONNX Runtime TensorEngine
+ */
+class TensorEngineSettings : public engines::BaseTensorEngineSettings
+{
+public:
+    static void registerSelf(QString const& name);
+
+    /**
+     * @brief model - path to onnx model
+     * @return
+     */
+    QString const& modelPath() const;
+
+    /**
+     * @brief level of graph optimizations: "disable", "basic", "extended" or "all"
+     * @return
+     */
+    QString const& graphOptimizationLevel() const;
+
+    /**
+     * @brief threads of one operator
+     * if zero will be equal threads per replica (or ONNX Runtime default)
+     * @return count
+     */
+    int intraOpThreads() const;
+
+    /**
+     * @brief threads for parallel operators, used only with parallel execution
+     * if zero will be ONNX Runtime default
+     * @return count
+     */
+    int interOpThreads() const;
+
+    /**
+     * @brief independent operators of graph are executed in parallel
+     * @return
+     */
+    bool parallelExecution() const;
+
+public: // IJsonParsed interface
+    bool parse(QJsonObject const& json) override;
+
+public: // ISettings interface
+    bool valid() const override;
+
+private:
+    QString m_modelPath{};
+    QString m_graphOptimizationLevel = "all";
+    int m_intraOpThreads = 0;
+    int m_interOpThreads = 0;
+    bool m_parallelExecution = false;
+};
+}
+}
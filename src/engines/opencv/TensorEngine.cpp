@@ -0,0 +1,208 @@
+#include "TensorEngine.h"
+
+#include <QLoggingCategory>
+#include <QFile>
+
+#include <algorithm>
+#include <vector>
+
+#include <opencv2/core/utility.hpp>
+
+
+namespace engines
+{
+namespace opencv
+{
+Q_LOGGING_CATEGORY(QLC_OPENCV_DNN, "OpenCvDnnEngine")
+
+static int backend(QString const& backend)
+{
+    if (backend == "opencv")
+    {
+        return cv::dnn::DNN_BACKEND_OPENCV;
+    }
+    if (backend == "openvino")
+    {
+        return cv::dnn::DNN_BACKEND_INFERENCE_ENGINE;
+    }
+    if (backend == "cuda")
+    {
+        return cv::dnn::DNN_BACKEND_CUDA;
+    }
+
+    return cv::dnn::DNN_BACKEND_DEFAULT;
+}
+
+static int target(QString const& target)
+{
+    if (target == "opencl")
+    {
+        return cv::dnn::DNN_TARGET_OPENCL;
+    }
+    if (target == "opencl_fp16")
+    {
+        return cv::dnn::DNN_TARGET_OPENCL_FP16;
+    }
+    if (target == "cuda")
+    {
+        return cv::dnn::DNN_TARGET_CUDA;
+    }
+    if (target == "cuda_fp16")
+    {
+        return cv::dnn::DNN_TARGET_CUDA_FP16;
+    }
+
+    return cv::dnn::DNN_TARGET_CPU;
+}
+
+bool TensorEngine::loadImpl(BaseTensorEngineSettings const& settings)
+{
+    auto const& opencvSettings = settings.toInstance<opencv::TensorEngineSettings>();
+
+    if (!opencvSettings)
+    {
+        qCCritical(QLC_OPENCV_DNN) << "Invalid setting for load opencv dnn tensor engine";
+        return false;
+    }
+    m_settings = opencvSettings;
+    m_batchInputN = inputWidth() * inputHeight() * inputChannels();
+
+    try
+    {
+        m_net = cv::dnn::readNetFromONNX(QFile::encodeName(m_settings->modelPath()).toStdString());
+        m_net.setPreferableBackend(backend(m_settings->backend()));
+        m_net.setPreferableTarget(target(m_settings->target()));
+    }
+    catch (std::exception const& ex)
+    {
+        qCCritical(QLC_OPENCV_DNN) << "Cannot load model:" << m_settings->modelPath() << "reason:" << ex.what();
+        return false;
+    }
+
+    if (m_net.empty())
+    {
+        qCCritical(QLC_OPENCV_DNN) << "Model is empty:" << m_settings->modelPath();
+        return false;
+    }
+
+    std::vector<int> const shape = {static_cast<int>(maxBatches()),
+                                    static_cast<int>(inputChannels()),
+                                    static_cast<int>(inputHeight()),
+                                    static_cast<int>(inputWidth())};
+    for (auto& input : m_inputs)
+    {
+        input = cv::Mat(shape, CV_32F, cv::Scalar(0));
+    }
+
+    qCInfo(QLC_OPENCV_DNN) << "Model" << m_settings->modelPath() << "loaded, backend:" << m_settings->backend()
+                           << "target:" << m_settings->target();
+    return true;
+}
+
+void TensorEngine::prepareThreadImpl(size_t maxThreads, std::vector<int> const&)
+{
+    auto const threads = m_settings->threads() > 0 ? static_cast<size_t>(m_settings->threads()) : maxThreads;
+    if (threads == 0)
+    {
+        return;
+    }
+
+    // pool of OpenCV is global, so its size is shared with image convertor and other replicas (last set wins),
+    // pool threads are not pinned, only infer thread which runs forward is pinned
+    cv::setNumThreads(static_cast<int>(threads));
+    qCInfo(QLC_OPENCV_DNN) << "OpenCV threads (process global):" << cv::getNumThreads();
+}
+
+size_t TensorEngine::maxBatches() const
+{
+    return m_settings->maxBatches();
+}
+
+size_t TensorEngine::inputWidth() const
+{
+    return m_settings->width();
+}
+
+size_t TensorEngine::inputHeight() const
+{
+    return m_settings->height();
+}
+
+size_t TensorEngine::inputChannels() const
+{
+    return m_settings->channels();
+}
+
+size_t TensorEngine::outputSize() const
+{
+    return m_settings->output();
+}
+
+bool TensorEngine::loadToInput(size_t batch, size_t offset, Tensor const* src, size_t n)
+{
+    if (!validateLoadInput(batch, offset, src, n))
+    {
+        return false;
+    }
+
+    auto const input = m_inputs[stagingBuffer()].ptr<Tensor>() + batch * batchInputN() + offset;
+    std::copy(src, src + n, input);
+
+    return true;
+}
+
+bool TensorEngine::unloadOutput(size_t batches, Tensor* dst)
+{
+    if (!validateLoadOutput(batches, dst))
+    {
+        return false;
+    }
+
+    auto const n = batches * batchOutputN();
+    if (m_output.type() != CV_32F || m_output.total() < n)
+    {
+        qCCritical(QLC_OPENCV_DNN) << "Unexpected output of network, total:" << m_output.total() << "required:" << n;
+        return false;
+    }
+
+    auto const src = m_output.ptr<Tensor>();
+    std::copy(src, src + n, dst);
+
+    return true;
+}
+
+bool TensorEngine::inferImpl(size_t buffer, size_t batches)
+{
+    // view of first batches of blob, without copy
+    std::vector<cv::Range> const ranges = {cv::Range(0, static_cast<int>(batches)), cv::Range::all(),
+                                           cv::Range::all(), cv::Range::all()};
+    cv::Mat const blob(m_inputs[buffer], ranges);
+
+    try
+    {
+        qCDebug(QLC_OPENCV_DNN) << "Starting infer batches" << batches;
+        m_net.setInput(blob);
+        m_output = m_net.forward();
+    }
+    catch (std::exception const& ex)
+    {
+        qCCritical(QLC_OPENCV_DNN) << "Forward failed, reason:" << ex.what();
+        return false;
+    }
+
+    qCDebug(QLC_OPENCV_DNN) << "Infer batches" << batches << "completed";
+
+    return true;
+}
+
+size_t TensorEngine::batchInputN() const
+{
+    return m_batchInputN;
+}
+
+size_t TensorEngine::batchOutputN() const
+{
+    return outputSize();
+}
+}
+}
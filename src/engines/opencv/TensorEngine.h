@@ -0,0 +1,50 @@
+#pragma once
+
+#include "engines/BaseTensorEngine.h"
+#include "engines/opencv/TensorEngineSettings.h"
+
+#include <array>
+#include <vector>
+
+#include <opencv2/core/mat.hpp>
+#include <opencv2/dnn.hpp>
+
+
+namespace engines
+{
+namespace opencv
+{
+/**
+ * @brief The TensorEngine class forward data through Neural Network by OpenCV DNN module
+ * input buffers are NCHW blobs, so planar channels of image convertor are loaded to them directly
+ */
+class TensorEngine : public engines::BaseTensorEngine
+{
+public:
+    TensorEngine() = default;
+
+public: // BaseTensorEngine interface
+    bool loadImpl(BaseTensorEngineSettings const& settings) override;
+    bool inferImpl(size_t buffer, size_t batches) override;
+    void prepareThreadImpl(size_t maxThreads, std::vector<int> const& cpus) override;
+
+public: // ITensorEngine interface
+    size_t maxBatches() const override;
+    size_t inputWidth() const override;
+    size_t inputHeight() const override;
+    size_t inputChannels() const override;
+    size_t outputSize() const override;
+    bool loadToInput(size_t batch, size_t offset, Tensor const*src, size_t n) override;
+    bool unloadOutput(size_t batches, Tensor *dst) override;
+    size_t batchInputN() const override;
+    size_t batchOutputN() const override;
+
+private:
+    TensorEngineSettings const* m_settings = nullptr;
+    cv::dnn::Net m_net{};
+    std::array<cv::Mat, INPUT_BUFFERS> m_inputs{};
+    cv::Mat m_output{};
+    size_t m_batchInputN = 0;
+};
+}
+}
@@ -0,0 +1,87 @@
+#include "TensorEngineSettings.h"
+#include "utils/JsonHelper.h"
+
+#include <QLoggingCategory>
+
+
+namespace engines
+{
+namespace opencv
+{
+Q_LOGGING_CATEGORY(QLC_OPENCV_DNN_SETTINGS, "OpenCvDnnSettings")
+static utils::JsonHelper const JSON_HELPER(QLC_OPENCV_DNN_SETTINGS);
+
+static QStringList const BACKENDS = {"default", "opencv", "openvino", "cuda"};
+static QStringList const TARGETS = {"cpu", "opencl", "opencl_fp16", "cuda", "cuda_fp16"};
+
+void TensorEngineSettings::registerSelf(QString const& name)
+{
+    registerType<TensorEngineSettings>(name);
+}
+
+size_t TensorEngineSettings::width() const
+{
+    return m_width;
+}
+
+size_t TensorEngineSettings::height() const
+{
+    return m_height;
+}
+
+size_t TensorEngineSettings::channels() const
+{
+    return m_channels;
+}
+
+size_t TensorEngineSettings::output() const
+{
+    return m_output;
+}
+
+QString const& TensorEngineSettings::modelPath() const
+{
+    return m_modelPath;
+}
+
+QString const& TensorEngineSettings::backend() const
+{
+    return m_backend;
+}
+
+QString const& TensorEngineSettings::target() const
+{
+    return m_target;
+}
+
+int TensorEngineSettings::threads() const
+{
+    return m_threads;
+}
+
+bool TensorEngineSettings::parse(QJsonObject const& json)
+{
+    JSON_HELPER.get(json, "backend", m_backend, false);
+    JSON_HELPER.get(json, "target", m_target, false);
+    JSON_HELPER.get(json, "threads", m_threads, false);
+    return JSON_HELPER.get(json, "width", m_width, true)
+           && JSON_HELPER.get(json, "height", m_height, true)
+           && JSON_HELPER.get(json, "channels", m_channels, true)
+           && JSON_HELPER.get(json, "output", m_output, true)
+           && JSON_HELPER.get(json, "modelPath", m_modelPath, true);
+}
+
+bool TensorEngineSettings::valid() const
+{
+    return BaseTensorEngineSettings::valid()
+            && width() > 0
+            && height() > 0
+            && channels() > 0
+            && output() > 0
+            && !modelPath().isEmpty()
+            && BACKENDS.contains(backend())
+            && TARGETS.contains(target())
+            && threads() >= 0;
+}
+}
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <QString>
+
+#include "engines/BaseTensorEngineSettings.h"
+
+
+namespace engines
+{
+namespace opencv
+{
+/**
+ * @brief The TensorEngineSettings class contains setting for build OpenCV DNN TensorEngine
+ */
+class TensorEngineSettings : public engines::BaseTensorEngineSettings
+{
+public:
+    static void registerSelf(QString const& name);
+
+    /**
+     * @brief input width
+     * @return
+     */
+    size_t width() const;
+
+    /**
+      * @brief input height
+      * @return
+      */
+    size_t height() const;
+
+    /**
+      * @brief input channels
+      * @return
+      */
+    size_t channels() const;
+
+    /**
+      * @brief output size
+      * @return
+      */
+    size_t output() const;
+
+    /**
+     * @brief model - path to onnx model
+     * @return
+     */
+    QString const& modelPath() const;
+
+    /**
+     * @brief computation backend: "default", "opencv", "openvino" or "cuda"
+     * @return
+     */
+    QString const& backend() const;
+
+    /**
+     * @brief target device: "cpu", "opencl", "opencl_fp16", "cuda" or "cuda_fp16"
+     * @return
+     */
+    QString const& target() const;
+
+    /**
+     * @brief threads of OpenCV, set on infer thread, but pool is global for process,
+     * so it is shared with image convertor and other replicas
+     * if zero will be threads per replica (or OpenCV default)
+     * @return count
+     */
+    int threads() const;
+
+public: // IJsonParsed interface
+    bool parse(QJsonObject const& json) override;
+
+public: // ISettings interface
+    bool valid() const override;
+
+private:
+    size_t m_width = 0;
+    size_t m_height = 0;
+    size_t m_channels = 0;
+    size_t m_output = 0;
+    QString m_modelPath{};
+    QString m_backend = "default";
+    QString m_target = "cpu";
+    int m_threads = 0;
+};
+}
+}
@@ -0,0 +1,150 @@
+#include "TensorEngine.h"
+
+#include <QLoggingCategory>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <numeric>
+#include <thread>
+
+
+namespace engines
+{
+namespace synthetic
+{
+Q_LOGGING_CATEGORY(QLC_SYNTHETIC, "SyntheticEngine")
+
+bool TensorEngine::loadImpl(BaseTensorEngineSettings const& settings)
+{
+    auto const& syntheticSettings = settings.toInstance<synthetic::TensorEngineSettings>();
+
+    if (!syntheticSettings)
+    {
+        qCCritical(QLC_SYNTHETIC) << "Invalid setting for load synthetic tensor engine";
+        return false;
+    }
+    m_settings = syntheticSettings;
+    m_batchInputN = inputWidth() * inputHeight() * inputChannels();
+    m_jitter.seed(static_cast<std::mt19937::result_type>(m_settings->seed()));
+
+    for (auto& input : m_inputs)
+    {
+        input = std::vector<Tensor>(batchInputN() * maxBatches());
+    }
+    m_output = std::vector<Tensor>(batchOutputN() * maxBatches());
+
+    qCInfo(QLC_SYNTHETIC) << "Synthetic engine loaded, latency us: fixed" << m_settings->fixedLatencyUs()
+                          << "per item" << m_settings->perItemLatencyUs() << "jitter" << m_settings->jitterUs();
+    return true;
+}
+
+size_t TensorEngine::maxBatches() const
+{
+    return m_settings->maxBatches();
+}
+
+size_t TensorEngine::inputWidth() const
+{
+    return m_settings->width();
+}
+
+size_t TensorEngine::inputHeight() const
+{
+    return m_settings->height();
+}
+
+size_t TensorEngine::inputChannels() const
+{
+    return m_settings->channels();
+}
+
+size_t TensorEngine::outputSize() const
+{
+    return m_settings->output();
+}
+
+bool TensorEngine::loadToInput(size_t batch, size_t offset, Tensor const* src, size_t n)
+{
+    if (!validateLoadInput(batch, offset, src, n))
+    {
+        return false;
+    }
+
+    auto const input = m_inputs[stagingBuffer()].data() + batch * batchInputN() + offset;
+    std::copy(src, src + n, input);
+
+    return true;
+}
+
+bool TensorEngine::unloadOutput(size_t batches, Tensor* dst)
+{
+    if (!validateLoadOutput(batches, dst))
+    {
+        return false;
+    }
+
+    auto const n = batches * batchOutputN();
+    std::copy(m_output.begin(), m_output.begin() + static_cast<std::ptrdiff_t>(n), dst);
+
+    return true;
+}
+
+bool TensorEngine::inferImpl(size_t buffer, size_t batches)
+{
+    // output is sigmoid of mean of input, so equal images give equal results
+    for (size_t b = 0; b < batches; ++b)
+    {
+        auto const input = m_inputs[buffer].begin() + static_cast<std::ptrdiff_t>(b * batchInputN());
+        auto const mean = std::accumulate(input, input + static_cast<std::ptrdiff_t>(batchInputN()), 0.0) / batchInputN();
+        auto const positive = static_cast<Tensor>(1 / (1 + std::exp(-mean)));
+
+        auto const output = m_output.begin() + static_cast<std::ptrdiff_t>(b * batchOutputN());
+        std::fill(output, output + static_cast<std::ptrdiff_t>(batchOutputN()), Tensor(0));
+        if (positiveIndex() < batchOutputN())
+        {
+            output[static_cast<std::ptrdiff_t>(positiveIndex())] = positive;
+        }
+        if (negativeIndex() < batchOutputN())
+        {
+            output[static_cast<std::ptrdiff_t>(negativeIndex())] = 1 - positive;
+        }
+    }
+
+    simulateLatency(batches);
+
+    return true;
+}
+
+void TensorEngine::simulateLatency(size_t batches)
+{
+    auto latencyUs = m_settings->fixedLatencyUs() + static_cast<qint64>(m_settings->perItemLatencyUs() * batches);
+    if (m_settings->jitterUs() > 0)
+    {
+        std::uniform_int_distribution<int> jitter(-m_settings->jitterUs(), m_settings->jitterUs());
+        latencyUs = std::max<qint64>(latencyUs + jitter(m_jitter), 0);
+    }
+
+    auto const deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(latencyUs);
+    if (!m_settings->busyWait())
+    {
+        std::this_thread::sleep_until(deadline);
+        return;
+    }
+
+    while (std::chrono::steady_clock::now() < deadline)
+    {
+    }
+}
+
+size_t TensorEngine::batchInputN() const
+{
+    return m_batchInputN;
+}
+
+size_t TensorEngine::batchOutputN() const
+{
+    return outputSize();
+}
+}
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "engines/BaseTensorEngine.h"
+#include "engines/synthetic/TensorEngineSettings.h"
+
+#include <array>
+#include <random>
+#include <vector>
+
+
+namespace engines
+{
+namespace synthetic
+{
+/**
+ * @brief The TensorEngine class simulates forward without Neural Network
+ * for testing throughput of pipeline, latency is taken from settings
+ * and output is deterministic function of input
+ */
+class TensorEngine : public engines::BaseTensorEngine
+{
+public:
+    TensorEngine() = default;
+
+public: // BaseTensorEngine interface
+    bool loadImpl(BaseTensorEngineSettings const& settings) override;
+    bool inferImpl(size_t buffer, size_t batches) override;
+
+public: // ITensorEngine interface
+    size_t maxBatches() const override;
+    size_t inputWidth() const override;
+    size_t inputHeight() const override;
+    size_t inputChannels() const override;
+    size_t outputSize() const override;
+    bool loadToInput(size_t batch, size_t offset, Tensor const*src, size_t n) override;
+    bool unloadOutput(size_t batches, Tensor *dst) override;
+    size_t batchInputN() const override;
+    size_t batchOutputN() const override;
+
+private:
+    /**
+     * @brief wait simulated latency of forward
+     * @param batches - count batches for forward
+     */
+    void simulateLatency(size_t batches);
+
+private:
+    TensorEngineSettings const* m_settings = nullptr;
+    std::array<std::vector<Tensor>, INPUT_BUFFERS> m_inputs{};
+    std::vector<Tensor> m_output{};
+    size_t m_batchInputN = 0;
+    std::mt19937 m_jitter{};
+};
+}
+}
@@ -0,0 +1,89 @@
+#include "TensorEngineSettings.h"
+#include "utils/JsonHelper.h"
+
+#include <QLoggingCategory>
+
+
+namespace engines
+{
+namespace synthetic
+{
+Q_LOGGING_CATEGORY(QLC_SYNTHETIC_SETTINGS, "SyntheticSettings")
+static utils::JsonHelper const JSON_HELPER(QLC_SYNTHETIC_SETTINGS);
+
+void TensorEngineSettings::registerSelf(QString const& name)
+{
+    registerType<TensorEngineSettings>(name);
+}
+
+size_t TensorEngineSettings::width() const
+{
+    return m_width;
+}
+
+size_t TensorEngineSettings::height() const
+{
+    return m_height;
+}
+
+size_t TensorEngineSettings::channels() const
+{
+    return m_channels;
+}
+
+size_t TensorEngineSettings::output() const
+{
+    return m_output;
+}
+
+int TensorEngineSettings::fixedLatencyUs() const
+{
+    return m_fixedLatencyUs;
+}
+
+int TensorEngineSettings::perItemLatencyUs() const
+{
+    return m_perItemLatencyUs;
+}
+
+int TensorEngineSettings::jitterUs() const
+{
+    return m_jitterUs;
+}
+
+int TensorEngineSettings::seed() const
+{
+    return m_seed;
+}
+
+bool TensorEngineSettings::busyWait() const
+{
+    return m_busyWait;
+}
+
+bool TensorEngineSettings::parse(QJsonObject const& json)
+{
+    JSON_HELPER.get(json, "fixedLatencyUs", m_fixedLatencyUs, false);
+    JSON_HELPER.get(json, "perItemLatencyUs", m_perItemLatencyUs, false);
+    JSON_HELPER.get(json, "jitterUs", m_jitterUs, false);
+    JSON_HELPER.get(json, "seed", m_seed, false);
+    JSON_HELPER.get(json, "busyWait", m_busyWait, false);
+    return JSON_HELPER.get(json, "width", m_width, true)
+           && JSON_HELPER.get(json, "height", m_height, true)
+           && JSON_HELPER.get(json, "channels", m_channels, true)
+           && JSON_HELPER.get(json, "output", m_output, true);
+}
+
+bool TensorEngineSettings::valid() const
+{
+    return BaseTensorEngineSettings::valid()
+            && width() > 0
+            && height() > 0
+            && channels() > 0
+            && output() > 0
+            && fixedLatencyUs() >= 0
+            && perItemLatencyUs() >= 0
+            && jitterUs() >= 0;
+}
+}
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <QString>
+
+#include "engines/BaseTensorEngineSettings.h"
+
+
+namespace engines
+{
+namespace synthetic
+{
+/**
+ * @brief The TensorEngineSettings class contains setting for build synthetic TensorEngine
+ * latency of forward is simulated as fixed + per batch item cost with jitter
+ */
+class TensorEngineSettings : public engines::BaseTensorEngineSettings
+{
+public:
+    static void registerSelf(QString const& name);
+
+    /**
+     * @brief input width
+     * @return
+     */
+    size_t width() const;
+
+    /**
+      * @brief input height
+      * @return
+      */
+    size_t height() const;
+
+    /**
+      * @brief input channels
+      * @return
+      */
+    size_t channels() const;
+
+    /**
+      * @brief output size
+      * @return
+      */
+    size_t output() const;
+
+    /**
+     * @brief fixed latency of forward in microseconds
+     * @return
+     */
+    int fixedLatencyUs() const;
+
+    /**
+     * @brief latency of each batch item in microseconds
+     * @return
+     */
+    int perItemLatencyUs() const;
+
+    /**
+     * @brief max deviation of latency in microseconds, uniformly distributed
+     * @return
+     */
+    int jitterUs() const;
+
+    /**
+     * @brief seed of jitter generator
+     * @return
+     */
+    int seed() const;
+
+    /**
+     * @brief simulate forward by busy waiting (CPU bound engine) instead of sleeping (GPU bound engine)
+     * @return
+     */
+    bool busyWait() const;
+
+public: // IJsonParsed interface
+    bool parse(QJsonObject const& json) override;
+
+public: // ISettings interface
+    bool valid() const override;
+
+private:
+    size_t m_width = 0;
+    size_t m_height = 0;
+    size_t m_channels = 0;
+    size_t m_output = 0;
+    int m_fixedLatencyUs = 0;
+    int m_perItemLatencyUs = 0;
+    int m_jitterUs = 0;
+    int m_seed = 0;
+    bool m_busyWait = false;
+};
+}
+}
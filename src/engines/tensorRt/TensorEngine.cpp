@@ -84,16 +84,19 @@ bool TensorEngine::loadImpl(engines::BaseTensorEngineSettings const& settings)
     auto const inputSize = batchInputN * engine->getMaxBatchSize() * sizeof(Tensor);
     auto const outputSize = batchOutputN * engine->getMaxBatchSize() * sizeof(Tensor);
 
-    void* input = nullptr;
-    void* output = nullptr;
-
-    if (cudaMalloc(&input, inputSize) != ::cudaSuccess)
+    std::array<CudaMemPtr, INPUT_BUFFERS> inputPtrs{};
+    for (auto& inputPtr : inputPtrs)
     {
-        qCCritical(QLC_TENSOR_RT_ENGINE) << "Cuda memory alloc failed bytes required:" << inputSize;
-        return false;
+        void* input = nullptr;
+        if (cudaMalloc(&input, inputSize) != ::cudaSuccess)
+        {
+            qCCritical(QLC_TENSOR_RT_ENGINE) << "Cuda memory alloc failed bytes required:" << inputSize;
+            return false;
+        }
+        inputPtr.reset(input);
     }
-    CudaMemPtr inputPtr(input);
 
+    void* output = nullptr;
     if (cudaMalloc(&output, outputSize) != ::cudaSuccess)
     {
         qCCritical(QLC_TENSOR_RT_ENGINE) << "Cuda memory alloc failed bytes required:" << outputSize;
@@ -101,8 +104,27 @@ bool TensorEngine::loadImpl(engines::BaseTensorEngineSettings const& settings)
     }
     CudaMemPtr outputPtr(output);
 
-    m_input = std::move(inputPtr);
+    // non blocking streams, so copying to one input buffer is not serialized with forward of another
+    cudaStream_t copyStream = nullptr;
+    cudaStream_t inferStream = nullptr;
+    if (cudaStreamCreateWithFlags(&copyStream, cudaStreamNonBlocking) != ::cudaSuccess)
+    {
+        qCCritical(QLC_TENSOR_RT_ENGINE) << "Creating cuda copy stream failed";
+        return false;
+    }
+    CudaStreamPtr copyStreamPtr(copyStream);
+
+    if (cudaStreamCreateWithFlags(&inferStream, cudaStreamNonBlocking) != ::cudaSuccess)
+    {
+        qCCritical(QLC_TENSOR_RT_ENGINE) << "Creating cuda infer stream failed";
+        return false;
+    }
+    CudaStreamPtr inferStreamPtr(inferStream);
+
+    m_inputs = std::move(inputPtrs);
     m_output = std::move(outputPtr);
+    m_copyStream = std::move(copyStreamPtr);
+    m_inferStream = std::move(inferStreamPtr);
     m_inputDim = inputDim;
     m_outputDim = outputDim;
     m_batchInputN = batchInputN;
@@ -155,10 +177,11 @@ bool TensorEngine::loadToInput(size_t batch, size_t offset, Tensor const* src, s
         return false;
     }
 
-    auto const input = static_cast<void*>(static_cast<Tensor*>(m_input.get()) + batch * batchInputN() + offset);
+    auto const input = static_cast<void*>(static_cast<Tensor*>(m_inputs[stagingBuffer()].get()) + batch * batchInputN() + offset);
     auto const count = n * sizeof(Tensor);
 
-    bool const result = cudaMemcpy(input, src, count, cudaMemcpyHostToDevice) == ::cudaSuccess;
+    bool const result = cudaMemcpyAsync(input, src, count, cudaMemcpyHostToDevice, m_copyStream.get()) == ::cudaSuccess
+            && cudaStreamSynchronize(m_copyStream.get()) == ::cudaSuccess;
     qCDebug(QLC_TENSOR_RT_ENGINE) << "Copy data to device, batch:" << batch
                                   << "offset:" << offset
                                   << "count:" << n
@@ -175,7 +198,8 @@ bool TensorEngine::unloadOutput(size_t batches, Tensor* dst)
     }
 
     auto const count = batches * batchOutputN() * sizeof(Tensor);
-    bool const result = cudaMemcpy(dst, m_output.get(), count, cudaMemcpyDeviceToHost)  == ::cudaSuccess;
+    bool const result = cudaMemcpyAsync(dst, m_output.get(), count, cudaMemcpyDeviceToHost, m_copyStream.get()) == ::cudaSuccess
+            && cudaStreamSynchronize(m_copyStream.get()) == ::cudaSuccess;
 
     qCDebug(QLC_TENSOR_RT_ENGINE) << "Unload data from device, batches:" << batches
                                   << (result ? "completed" : "failed");
@@ -183,17 +207,13 @@ bool TensorEngine::unloadOutput(size_t batches, Tensor* dst)
     return true;
 }
 
-bool TensorEngine::infer(size_t batches)
+bool TensorEngine::inferImpl(size_t buffer, size_t batches)
 {
-    if (!validateInfer(batches))
-    {
-        return false;
-    }
-
     qCInfo(QLC_TENSOR_RT_ENGINE) << "Starting infer batches" << batches;
 
-    void* bindings[] = {m_input.get(), m_output.get()};
-    bool const result = m_executionContext->execute(batches, bindings);
+    void* bindings[] = {m_inputs[buffer].get(), m_output.get()};
+    bool const result = m_executionContext->enqueue(batches, bindings, m_inferStream.get(), nullptr)
+            && cudaStreamSynchronize(m_inferStream.get()) == ::cudaSuccess;
 
     qCInfo(QLC_TENSOR_RT_ENGINE) << "Infer batches" << batches << (result ? "completed" : "failed");
 
@@ -2,8 +2,10 @@
 
 #include "engines/BaseTensorEngine.h"
 
+#include <array>
 #include <memory>
 #include <cstdint>
+#include <type_traits>
 #include <QString>
 
 #include <cuda.h>
@@ -34,6 +36,7 @@ public:
 
 public: // BaseTensorEngine interface
     bool loadImpl(BaseTensorEngineSettings const& settings) override;
+    bool inferImpl(size_t buffer, size_t batches) override;
 
 public: // ITensorEngine interface
     size_t maxBatches() const override;
@@ -45,7 +48,6 @@ public: // ITensorEngine interface
     size_t batchOutputN() const override;
     bool loadToInput(size_t batch, size_t offset, Tensor const* src, size_t n) override;
     bool unloadOutput(size_t batches, Tensor* dst) override;
-    bool infer(size_t batches) override;
 
 private:
     /**
@@ -71,6 +73,17 @@ private:
         }
     };
 
+    /**
+     * @brief The CudaStreamDeleter struct - custom deleter for cuda stream
+     */
+    struct CudaStreamDeleter
+    {
+        void operator () (cudaStream_t stream)
+        {
+            cudaStreamDestroy(stream);
+        }
+    };
+
     // Smart pointers with overrided deleters
     using ICudaEnginePtr = std::unique_ptr<nvinfer1::ICudaEngine, NvDeleter<nvinfer1::ICudaEngine>>;
     using IExecutionContextPtr = std::unique_ptr<nvinfer1::IExecutionContext, NvDeleter<nvinfer1::IExecutionContext>>;
@@ -81,6 +94,7 @@ private:
     using IHostMemoryPtr = std::unique_ptr<nvinfer1::IHostMemory, NvDeleter<nvinfer1::IHostMemory>>;
     using IParserPtr = std::unique_ptr<nvonnxparser::IParser, NvDeleter<nvonnxparser::IParser>>;
     using CudaMemPtr = std::unique_ptr<void, CudaDeleter>;
+    using CudaStreamPtr = std::unique_ptr<std::remove_pointer_t<cudaStream_t>, CudaStreamDeleter>;
 
 private:
     /**
@@ -110,8 +124,10 @@ private:
     static size_t getSize(nvinfer1::Dims const& dims);
 
 private:
-    CudaMemPtr m_input = nullptr;
+    std::array<CudaMemPtr, INPUT_BUFFERS> m_inputs{};
     CudaMemPtr m_output = nullptr;
+    CudaStreamPtr m_copyStream = nullptr;
+    CudaStreamPtr m_inferStream = nullptr;
     nvinfer1::Dims m_inputDim{};
     nvinfer1::Dims m_outputDim{};
     size_t m_batchInputN = 0;
@@ -1,6 +1,18 @@
 #include "TensorEngine.h"
+#include "utils/ThreadAffinity.h"
 
 #include <QLoggingCategory>
+#include <QCryptographicHash>
+#include <QFileInfo>
+#include <QFile>
+#include <QDir>
+
+#include <algorithm>
+#include <mutex>
+
+#include <ATen/autocast_mode.h>
+#include <torch/csrc/jit/python/update_graph_executor_opt.h>
+#include <torch/version.h>
 
 
 namespace engines
@@ -9,6 +21,87 @@ namespace torch
 {
 Q_LOGGING_CATEGORY(QLC_TORCH, "TorchEngine")
 
+/**
+ * @brief cpu has native bfloat16 instructions, without them bf16 kernels are emulated and slower than fp32
+ * @return
+ */
+static bool cpuSupportsBf16()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_cpu_supports("avx512bf16") || __builtin_cpu_supports("amx-bf16");
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief The CpuAutocast struct enables bfloat16 autocast for cpu ops of current thread while alive
+ */
+struct CpuAutocast
+{
+#if TORCH_VERSION_MAJOR > 2 || (TORCH_VERSION_MAJOR == 2 && TORCH_VERSION_MINOR >= 4)
+    CpuAutocast()
+        : m_enabled(at::autocast::is_autocast_enabled(at::kCPU))
+        , m_dtype(at::autocast::get_autocast_dtype(at::kCPU))
+    {
+        at::autocast::set_autocast_dtype(at::kCPU, at::kBFloat16);
+        at::autocast::set_autocast_enabled(at::kCPU, true);
+    }
+
+    ~CpuAutocast()
+    {
+        at::autocast::set_autocast_enabled(at::kCPU, m_enabled);
+        at::autocast::set_autocast_dtype(at::kCPU, m_dtype);
+    }
+#else
+    // device generic api is available since torch 2.4
+    CpuAutocast()
+        : m_enabled(at::autocast::is_cpu_enabled())
+        , m_dtype(at::autocast::get_autocast_cpu_dtype())
+    {
+        at::autocast::set_autocast_cpu_dtype(at::kBFloat16);
+        at::autocast::set_cpu_enabled(true);
+    }
+
+    ~CpuAutocast()
+    {
+        at::autocast::set_cpu_enabled(m_enabled);
+        at::autocast::set_autocast_cpu_dtype(m_dtype);
+    }
+#endif
+
+    CpuAutocast(CpuAutocast const&) = delete;
+    CpuAutocast& operator=(CpuAutocast const&) = delete;
+
+private:
+    bool const m_enabled;
+    at::ScalarType const m_dtype;
+};
+
+/**
+ * @brief The GraphExecutorOptimizeGuard struct sets optimization of JIT graph executor while alive,
+ * switch is shared by process (thread local in newer torch), so previous value is restored
+ */
+struct GraphExecutorOptimizeGuard
+{
+    explicit GraphExecutorOptimizeGuard(bool optimize)
+        : m_previous(::torch::jit::getGraphExecutorOptimize())
+    {
+        ::torch::jit::setGraphExecutorOptimize(optimize);
+    }
+
+    ~GraphExecutorOptimizeGuard()
+    {
+        ::torch::jit::setGraphExecutorOptimize(m_previous);
+    }
+
+    GraphExecutorOptimizeGuard(GraphExecutorOptimizeGuard const&) = delete;
+    GraphExecutorOptimizeGuard& operator=(GraphExecutorOptimizeGuard const&) = delete;
+
+private:
+    bool const m_previous;
+};
+
 bool TensorEngine::loadImpl(BaseTensorEngineSettings const& settings)
 {
     auto const& torchSettigs = settings.toInstance<torch::TensorEngineSettings>();
@@ -34,17 +127,20 @@ bool TensorEngine::loadImpl(BaseTensorEngineSettings const& settings)
         }
     }
 
-    try
-    {
-        m_module = ::torch::jit::load(qPrintable(m_settings->modelPath()), m_device);
-    }
-    catch (std::exception const& ex)
+    // kernels are selected by global context on dispatch
+    at::globalContext().setUserEnabledMkldnn(m_settings->oneDnn());
+    qCInfo(QLC_TORCH) << "oneDNN enabled:" << at::globalContext().userEnabledMkldnn();
+
+    // packed weights of quantized model are created for backend while loading
+    if (!setQuantizedEngine() || !setPrecision() || !loadModule())
     {
-        qCCritical(QLC_TORCH) << "Cannot load script:" << m_settings->modelPath() << "reason:" << ex.what();
         return false;
     }
 
-    m_input = std::vector<Tensor>(batchInputN() * maxBatches());
+    for (auto& input : m_inputs)
+    {
+        input = std::vector<Tensor>(batchInputN() * maxBatches());
+    }
 
     qCInfo(QLC_TORCH) << "Model" << m_settings->modelPath() << "loaded";
     return true;
@@ -82,7 +178,7 @@ bool TensorEngine::loadToInput(size_t batch, size_t offset, Tensor const* src, s
         return false;
     }
 
-    auto const input = m_input.data() + batch * batchInputN() + offset;
+    auto const input = m_inputs[stagingBuffer()].data() + batch * batchInputN() + offset;
     std::copy(src, src + n, input);
 
     return true;
@@ -95,7 +191,8 @@ bool TensorEngine::unloadOutput(size_t batches, Tensor* dst)
         return false;
     }
 
-    auto const tensor = m_output.toTensor().cpu();
+    // output of autocast forward may be bfloat16
+    auto const tensor = m_output.toTensor().cpu().to(::torch::kFloat32).contiguous();
     auto const n = batches * batchOutputN();
     auto const src = tensor.data_ptr<float>();
 
@@ -109,15 +206,10 @@ bool TensorEngine::unloadOutput(size_t batches, Tensor* dst)
     return true;
 }
 
-bool TensorEngine::infer(size_t batches)
+bool TensorEngine::inferImpl(size_t buffer, size_t batches)
 {
-    if (!validateInfer(batches))
-    {
-        return false;
-    }
-
     auto ivalue = ::torch::from_blob(
-                m_input.data(),
+                m_inputs[buffer].data(),
     {static_cast<int>(batches),
      static_cast<int>(inputChannels()),
      static_cast<int>(inputHeight()),
@@ -132,7 +224,16 @@ bool TensorEngine::infer(size_t batches)
     try
     {
         qCInfo(QLC_TORCH) << "Starting infer batches" << batches;
-        m_output = m_module.forward({ivalue});
+        if (m_bf16)
+        {
+            // input stays fp32, autocast casts it only for ops of its bf16 list
+            CpuAutocast autocast;
+            m_output = m_module.forward({ivalue});
+        }
+        else
+        {
+            m_output = m_module.forward({ivalue});
+        }
     }
     catch(std::exception const& ex)
     {
@@ -145,6 +246,265 @@ bool TensorEngine::infer(size_t batches)
     return true;
 }
 
+void TensorEngine::prepareThreadImpl(size_t maxThreads, std::vector<int> const& cpus)
+{
+    auto const intraOpThreads = m_settings->intraOpThreads() > 0 ? static_cast<size_t>(m_settings->intraOpThreads()) : maxThreads;
+    if (intraOpThreads > 0)
+    {
+        // intra-op pool size is set for infer thread, so each replica has own budget
+        at::set_num_threads(static_cast<int>(intraOpThreads));
+        qCInfo(QLC_TORCH) << "Intra-op threads:" << at::get_num_threads();
+    }
+
+    if (m_settings->interOpThreads() > 0)
+    {
+        // inter-op pool is shared by process and can be sized only once before its first use
+        static std::once_flag interOpThreadsFlag;
+        std::call_once(interOpThreadsFlag, [this] {
+            try
+            {
+                at::set_num_interop_threads(m_settings->interOpThreads());
+                qCInfo(QLC_TORCH) << "Inter-op threads:" << at::get_num_interop_threads();
+            }
+            catch (std::exception const& ex)
+            {
+                qCWarning(QLC_TORCH) << "Cannot set inter-op threads, reason:" << ex.what();
+            }
+        });
+    }
+
+    auto const flushDenormal = m_settings->flushDenormal();
+    if (!cpus.empty() || flushDenormal)
+    {
+        // affinity and flush mode of cpu are states of thread, so each intra-op thread sets them itself
+        at::parallel_for(0, at::get_num_threads(), 1, [&cpus, flushDenormal] (int64_t, int64_t) {
+            utils::ThreadAffinity::pinCurrentThread(cpus);
+            at::globalContext().setFlushDenormal(flushDenormal);
+        });
+        at::globalContext().setFlushDenormal(flushDenormal);
+    }
+
+    if (flushDenormal)
+    {
+        qCInfo(QLC_TORCH) << "Denormals are flushed to zero on infer and intra-op threads";
+    }
+
+    if (!cpus.empty())
+    {
+        // pages are allocated on NUMA node of thread which touches them first
+        for (auto& input : m_inputs)
+        {
+            input = std::vector<Tensor>(batchInputN() * maxBatches());
+        }
+
+        qCInfo(QLC_TORCH) << "Intra-op threads and input buffers placed on pinned cpus";
+    }
+}
+
+std::shared_ptr<void> TensorEngine::createInferThreadContext()
+{
+    // guard is thread local, forwards on infer thread record no autograd graph and version counters
+    qCInfo(QLC_TORCH) << "Inference mode enabled on infer thread";
+    return std::make_shared<c10::InferenceMode>();
+}
+
+bool TensorEngine::setQuantizedEngine()
+{
+    auto const& name = m_settings->quantizedEngine();
+    if (name.isEmpty())
+    {
+        return true;
+    }
+
+    auto const engine = name == "qnnpack" ? at::QEngine::QNNPACK : at::QEngine::FBGEMM;
+    auto const& supported = at::globalContext().supportedQEngines();
+    if (std::find(supported.begin(), supported.end(), engine) == supported.end())
+    {
+        qCCritical(QLC_TORCH) << "Quantized engine is not supported by torch build:" << name;
+        return false;
+    }
+
+    if (m_device && !m_device->is_cpu())
+    {
+        qCCritical(QLC_TORCH) << "Quantized kernels run only on cpu, device:" << m_settings->device();
+        return false;
+    }
+
+    at::globalContext().setQEngine(engine);
+    qCInfo(QLC_TORCH) << "Quantized engine:" << name;
+    return true;
+}
+
+bool TensorEngine::setPrecision()
+{
+    m_bf16 = false;
+    if (m_settings->precision() != "bf16")
+    {
+        qCInfo(QLC_TORCH) << "Precision: fp32";
+        return true;
+    }
+
+    // INT8 model quantizes fp32 input itself and optimized model has fp32 weights prepacked for oneDNN
+    if (!m_settings->quantizedEngine().isEmpty())
+    {
+        qCCritical(QLC_TORCH) << "bf16 precision cannot be combined with quantized engine:" << m_settings->quantizedEngine();
+        return false;
+    }
+    if (m_settings->optimize())
+    {
+        qCCritical(QLC_TORCH) << "bf16 precision cannot be combined with optimized model";
+        return false;
+    }
+
+    if (m_device && !m_device->is_cpu())
+    {
+        qCWarning(QLC_TORCH) << "bf16 autocast is supported only on cpu, fallback to fp32, device:" << m_settings->device();
+        return true;
+    }
+
+    if (!cpuSupportsBf16())
+    {
+        qCWarning(QLC_TORCH) << "CPU has no AVX512-BF16/AMX, fallback to fp32";
+        return true;
+    }
+
+    m_bf16 = true;
+    qCInfo(QLC_TORCH) << "Precision: bf16 autocast";
+    return true;
+}
+
+bool TensorEngine::loadModule()
+{
+    if (m_settings->optimize())
+    {
+        // graph is optimized ahead, so executor runs it without profiling runs and passes,
+        // plan of executor is fixed by first forward, then switch is restored for other modules
+        GraphExecutorOptimizeGuard guard(false);
+        return loadOptimizedModule() && warmupModule();
+    }
+
+    try
+    {
+        m_module = ::torch::jit::load(qPrintable(m_settings->modelPath()), m_device);
+    }
+    catch (std::exception const& ex)
+    {
+        qCCritical(QLC_TORCH) << "Cannot load script:" << m_settings->modelPath() << "reason:" << ex.what();
+        return false;
+    }
+
+    return true;
+}
+
+bool TensorEngine::loadOptimizedModule()
+{
+    auto const optimizedPath = optimizedModulePath();
+    if (optimizedPath.isEmpty())
+    {
+        qCCritical(QLC_TORCH) << "Cannot read model:" << m_settings->modelPath();
+        return false;
+    }
+
+    if (QFile::exists(optimizedPath))
+    {
+        try
+        {
+            m_module = ::torch::jit::load(qPrintable(optimizedPath), m_device);
+            qCInfo(QLC_TORCH) << "Optimized model loaded from cache:" << optimizedPath;
+            return true;
+        }
+        catch (std::exception const& ex)
+        {
+            qCWarning(QLC_TORCH) << "Cannot load cached optimized model:" << optimizedPath << "reason:" << ex.what();
+        }
+    }
+
+    try
+    {
+        auto module = ::torch::jit::load(qPrintable(m_settings->modelPath()), m_device);
+        module.eval();
+        auto frozen = ::torch::jit::freeze(module);
+        m_module = ::torch::jit::optimize_for_inference(frozen);
+    }
+    catch (std::exception const& ex)
+    {
+        qCCritical(QLC_TORCH) << "Cannot optimize script:" << m_settings->modelPath() << "reason:" << ex.what();
+        return false;
+    }
+
+    // saved to temporary file first, so other process never loads partial cache
+    auto const temporaryPath = optimizedPath + ".tmp";
+    try
+    {
+        m_module.save(qPrintable(temporaryPath));
+        QFile::remove(optimizedPath);
+        if (!QFile::rename(temporaryPath, optimizedPath))
+        {
+            qCWarning(QLC_TORCH) << "Cannot rename optimized model to:" << optimizedPath;
+            QFile::remove(temporaryPath);
+        }
+        else
+        {
+            qCInfo(QLC_TORCH) << "Optimized model saved to cache:" << optimizedPath;
+        }
+    }
+    catch (std::exception const& ex)
+    {
+        qCWarning(QLC_TORCH) << "Cannot save optimized model:" << optimizedPath << "reason:" << ex.what();
+        QFile::remove(temporaryPath);
+    }
+
+    return true;
+}
+
+bool TensorEngine::warmupModule()
+{
+    try
+    {
+        c10::InferenceMode guard;
+        auto input = ::torch::zeros({1,
+                                     static_cast<int>(inputChannels()),
+                                     static_cast<int>(inputHeight()),
+                                     static_cast<int>(inputWidth())});
+        if (m_device)
+        {
+            input = input.to(*m_device);
+        }
+        m_module.forward({input});
+    }
+    catch (std::exception const& ex)
+    {
+        qCCritical(QLC_TORCH) << "Warmup forward failed, reason:" << ex.what();
+        return false;
+    }
+
+    return true;
+}
+
+QString TensorEngine::optimizedModulePath() const
+{
+    QFile file(m_settings->modelPath());
+    if (!file.open(QFile::ReadOnly))
+    {
+        return {};
+    }
+
+    // optimized graph depends on model, device and kernels of torch build
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    if (!hash.addData(&file))
+    {
+        return {};
+    }
+    hash.addData(m_device ? m_device->str().c_str() : "cpu");
+    hash.addData(TORCH_VERSION);
+    hash.addData(m_settings->oneDnn() ? "oneDnn" : "native");
+    hash.addData(m_settings->quantizedEngine().toLatin1());
+
+    QFileInfo const info(m_settings->modelPath());
+    auto const key = QString::fromLatin1(hash.result().toHex().left(16));
+    return info.dir().filePath(info.completeBaseName() + "." + key + ".optimized.pt");
+}
+
 size_t TensorEngine::batchInputN() const
 {
     return m_batchInputN;
@@ -154,5 +514,10 @@ size_t TensorEngine::batchOutputN() const
 {
     return outputSize();
 }
+
+::torch::IValue const& TensorEngine::output() const
+{
+    return m_output;
+}
 }
 }
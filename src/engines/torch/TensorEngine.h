@@ -3,6 +3,10 @@
 #include "engines/BaseTensorEngine.h"
 #include "engines/torch/TensorEngineSettings.h"
 
+#include <array>
+#include <memory>
+#include <vector>
+
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-parameter"
 #include <torch/script.h>
@@ -23,6 +27,9 @@ public:
 
 public: // BaseTensorEngine interface
     bool loadImpl(BaseTensorEngineSettings const& settings) override;
+    bool inferImpl(size_t buffer, size_t batches) override;
+    void prepareThreadImpl(size_t maxThreads, std::vector<int> const& cpus) override;
+    std::shared_ptr<void> createInferThreadContext() override;
 
 public: // ITensorEngine interface
     size_t maxBatches() const override;
@@ -32,16 +39,59 @@ public: // ITensorEngine interface
     size_t outputSize() const override;
     bool loadToInput(size_t batch, size_t offset, Tensor const*src, size_t n) override;
     bool unloadOutput(size_t batches, Tensor *dst) override;
-    bool infer(size_t batches) override;
     size_t batchInputN() const override;
     size_t batchOutputN() const override;
 
+protected:
+    /**
+     * @brief output of last forward
+     * @return
+     */
+    ::torch::IValue const& output() const;
+
+private:
+    /**
+     * @brief select backend of quantized kernels from settings
+     * @return success (false - backend is not supported or device is not cpu)
+     */
+    bool setQuantizedEngine();
+
+    /**
+     * @brief select precision of forward from settings, bf16 only if supported by device and cpu
+     * @return success (false - bf16 combined with quantized engine or optimize)
+     */
+    bool setPrecision();
+
+    /**
+     * @brief load model, frozen and optimized if enabled
+     * @return success
+     */
+    bool loadModule();
+
+    /**
+     * @brief load optimized model from cache or optimize model and save it to cache
+     * @return success
+     */
+    bool loadOptimizedModule();
+
+    /**
+     * @brief forward dummy input once, so plan of graph executor is created
+     * @return success
+     */
+    bool warmupModule();
+
+    /**
+     * @brief path of cached optimized model, keyed by hash of model, device and build of torch
+     * @return path (empty - model cannot be read)
+     */
+    QString optimizedModulePath() const;
+
 private:
     TensorEngineSettings const* m_settings = nullptr;
-    ::torch::NoGradGuard noGrad{};
     c10::optional<c10::Device> m_device = c10::nullopt;
     ::torch::jit::script::Module m_module{};
-    std::vector<Tensor> m_input{};
+    bool m_bf16 = false;
+    std::array<std::vector<Tensor>, INPUT_BUFFERS> m_inputs{};
     ::torch::IValue m_output{};
     size_t m_batchInputN = 0;
 };
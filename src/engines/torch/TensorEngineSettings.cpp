@@ -11,6 +11,9 @@ namespace torch
 Q_LOGGING_CATEGORY(QLC_TORCH_SETTINGS, "TorchSettings")
 static utils::JsonHelper const JSON_HELPER(QLC_TORCH_SETTINGS);
 
+static QStringList const QUANTIZED_ENGINES = {"", "fbgemm", "qnnpack"};
+static QStringList const PRECISIONS = {"fp32", "bf16"};
+
 void TensorEngineSettings::registerSelf(QString const& name)
 {
     registerType<TensorEngineSettings>(name);
@@ -46,9 +49,51 @@ QString const& TensorEngineSettings::device() const
     return m_device;
 }
 
+int TensorEngineSettings::intraOpThreads() const
+{
+    return m_intraOpThreads;
+}
+
+int TensorEngineSettings::interOpThreads() const
+{
+    return m_interOpThreads;
+}
+
+bool TensorEngineSettings::oneDnn() const
+{
+    return m_oneDnn;
+}
+
+bool TensorEngineSettings::flushDenormal() const
+{
+    return m_flushDenormal;
+}
+
+bool TensorEngineSettings::optimize() const
+{
+    return m_optimize;
+}
+
+QString const& TensorEngineSettings::quantizedEngine() const
+{
+    return m_quantizedEngine;
+}
+
+QString const& TensorEngineSettings::precision() const
+{
+    return m_precision;
+}
+
 bool TensorEngineSettings::parse(QJsonObject const& json)
 {
     JSON_HELPER.get(json, "device", m_device, false);
+    JSON_HELPER.get(json, "intraOpThreads", m_intraOpThreads, false);
+    JSON_HELPER.get(json, "interOpThreads", m_interOpThreads, false);
+    JSON_HELPER.get(json, "oneDnn", m_oneDnn, false);
+    JSON_HELPER.get(json, "flushDenormal", m_flushDenormal, false);
+    JSON_HELPER.get(json, "optimize", m_optimize, false);
+    JSON_HELPER.get(json, "quantizedEngine", m_quantizedEngine, false);
+    JSON_HELPER.get(json, "precision", m_precision, false);
     return JSON_HELPER.get(json, "width", m_width, true)
            && JSON_HELPER.get(json, "height", m_height, true)
            && JSON_HELPER.get(json, "channels", m_channels, true)
@@ -63,7 +108,11 @@ bool TensorEngineSettings::valid() const
             && height() > 0
             && channels() > 0
             && output() > 0
-            && !modelPath().isEmpty();
+            && !modelPath().isEmpty()
+            && intraOpThreads() >= 0
+            && interOpThreads() >= 0
+            && QUANTIZED_ENGINES.contains(quantizedEngine())
+            && PRECISIONS.contains(precision());
 }
 }
 }
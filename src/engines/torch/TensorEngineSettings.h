@@ -53,6 +53,54 @@ public:
      */
     QString const& device() const;
 
+    /**
+     * @brief threads of one operator, set on infer thread
+     * if zero will be equal threads per replica (or torch default)
+     * @return count
+     */
+    int intraOpThreads() const;
+
+    /**
+     * @brief threads for parallel operators of graph, shared by process
+     * if zero will be torch default
+     * @return count
+     */
+    int interOpThreads() const;
+
+    /**
+     * @brief enable oneDNN (MKLDNN) kernels for CPU
+     * @return
+     */
+    bool oneDnn() const;
+
+    /**
+     * @brief flush denormal floats to zero on infer and intra-op threads
+     * @return
+     */
+    bool flushDenormal() const;
+
+    /**
+     * @brief freeze and optimize model for inference (fusion, conv-bn folding, oneDNN prepacking),
+     * optimized model is cached next to model path keyed by its hash
+     * @return
+     */
+    bool optimize() const;
+
+    /**
+     * @brief backend of quantized kernels for INT8 models: "fbgemm" (x86) or "qnnpack" (ARM)
+     * if empty will be torch default, requires cpu device
+     * @return
+     */
+    QString const& quantizedEngine() const;
+
+    /**
+     * @brief precision of forward: "fp32" or "bf16" (CPU autocast of fp32 input),
+     * bf16 falls back to fp32 if cpu has no AVX512-BF16/AMX,
+     * bf16 cannot be combined with quantizedEngine or optimize
+     * @return
+     */
+    QString const& precision() const;
+
 public: // IJsonParsed interface
     bool parse(QJsonObject const& json) override;
 
@@ -66,6 +114,13 @@ private:
     size_t m_output = 0;
     QString m_modelPath{};
     QString m_device{};
+    int m_intraOpThreads = 0;
+    int m_interOpThreads = 0;
+    bool m_oneDnn = true;
+    bool m_flushDenormal = false;
+    bool m_optimize = false;
+    QString m_quantizedEngine{};
+    QString m_precision = "fp32";
 };
 }
 }
@@ -154,7 +154,7 @@ common::IEngineInputDataPtr ImageConvertor::prepare(cv::Mat source, ImageConvert
         return nullptr;
     }
 
-    auto crop = getAutoCropSize(source.size());
+    auto crop = getAutoCropSize(source.size(), cv::Size(m_settings.width(), m_settings.height()));
     crop.height = static_cast<int>(crop.height / m_settings.zoom());
     crop.width = static_cast<int>(crop.width / m_settings.zoom());
 
@@ -186,13 +186,13 @@ common::IEngineInputDataPtr ImageConvertor::prepare(cv::Mat source, ImageConvert
     return std::make_shared<EngineInputData>(std::move(channels));
 }
 
-cv::Size ImageConvertor::getAutoCropSize(cv::Size const& source) const
+cv::Size getAutoCropSize(cv::Size const& source, cv::Size const& target)
 {
     cv::Size crop(0, 0);
 
-    if (m_settings.height() > m_settings.width())
+    if (target.height > target.width)
     {
-        auto const r = static_cast<float>(m_settings.width()) / m_settings.height();
+        auto const r = static_cast<float>(target.width) / target.height;
         auto const a = r * source.height;
 
         if (a <= source.width)
@@ -208,7 +208,7 @@ cv::Size ImageConvertor::getAutoCropSize(cv::Size const& source) const
     }
     else
     {
-        auto const r = static_cast<float>(m_settings.height()) / m_settings.width();
+        auto const r = static_cast<float>(target.height) / target.width;
         auto const a = r * source.width;
 
         if (a <= source.height)
@@ -9,6 +9,14 @@ namespace image
 {
 namespace opencv
 {
+/**
+ * @brief get auto crop size of source by size ratio of target
+ * @param source - source size
+ * @param target - target size
+ * @return size
+ */
+cv::Size getAutoCropSize(cv::Size const& source, cv::Size const& target);
+
 /**
  * @brief The ImageConvertor class - convert image for pass data to TensorEngine
  */
@@ -34,13 +42,6 @@ private:
      */
     common::IEngineInputDataPtr prepare(cv::Mat source, ImageConvertorTypeError* error = nullptr) const;
 
-    /**
-     * @brief get auto crop size by size ratio in settings
-     * @param source - source size
-     * @return size
-     */
-    cv::Size getAutoCropSize(cv::Size const& source) const;
-
     /**
      * @brief write error to pointer
      * @param dst
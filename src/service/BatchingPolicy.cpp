@@ -0,0 +1,101 @@
+#include "BatchingPolicy.h"
+
+#include "engines/BaseTensorEngineSettings.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace service
+{
+BatchingPolicy::BatchingPolicy(engines::BaseTensorEngineSettings const& settings, size_t maxBatches)
+    : m_maxBatches(std::max<size_t>(maxBatches, 1))
+    , m_maxWaitNs(static_cast<qint64>(settings.maxBatchWaitUs()) * 1000)
+    , m_latencyBudgetNs(static_cast<qint64>(settings.latencyBudgetUs()) * 1000)
+{
+    auto const target = static_cast<size_t>(std::ceil(settings.targetBatchFill() * m_maxBatches));
+    m_targetBatches = std::clamp<size_t>(target, 1, m_maxBatches);
+}
+
+size_t BatchingPolicy::maxBatches() const
+{
+    return m_maxBatches;
+}
+
+size_t BatchingPolicy::targetBatches() const
+{
+    return m_targetBatches;
+}
+
+void BatchingPolicy::setLatencyEstimator(LatencyEstimatorPtr const& latencyEstimator)
+{
+    m_latencyEstimator = latencyEstimator;
+}
+
+qint64 BatchingPolicy::batchCost(size_t batches) const
+{
+    if (!m_latencyEstimator || batches == 0 || batches > m_maxBatches)
+    {
+        return -1;
+    }
+
+    return m_latencyEstimator->batchCost(batches);
+}
+
+void BatchingPolicy::record(size_t batches)
+{
+    if (batches == 0 || batches > m_maxBatches)
+    {
+        return;
+    }
+
+    m_countBatches++;
+    m_countRequests += batches;
+}
+
+qint64 BatchingPolicy::holdNs(size_t batches, qint64 oldestAgeNs, qint64 deadlineSlackNs) const
+{
+    if (batches == 0 || batches >= m_targetBatches || m_maxWaitNs <= 0)
+    {
+        return 0;
+    }
+
+    auto hold = m_maxWaitNs - oldestAgeNs;
+
+    auto const targetCost = batchCost(m_targetBatches);
+    if (m_latencyBudgetNs > 0)
+    {
+        hold = std::min(hold, m_latencyBudgetNs - oldestAgeNs - std::max<qint64>(targetCost, 0));
+    }
+    if (deadlineSlackNs != std::numeric_limits<qint64>::max())
+    {
+        hold = std::min(hold, deadlineSlackNs - std::max<qint64>(targetCost, 0));
+    }
+
+    if (hold <= 0)
+    {
+        return 0;
+    }
+
+    // holding makes sense only if bigger batch is cheaper per request
+    auto const currentCost = batchCost(batches);
+    if (currentCost >= 0 && targetCost >= 0
+            && currentCost * static_cast<qint64>(m_targetBatches) <= targetCost * static_cast<qint64>(batches))
+    {
+        return 0;
+    }
+
+    return hold;
+}
+
+double BatchingPolicy::fillRatio() const
+{
+    quint64 const countBatches = m_countBatches;
+    if (countBatches == 0)
+    {
+        return 0;
+    }
+
+    return static_cast<double>(m_countRequests) / (countBatches * m_maxBatches);
+}
+}
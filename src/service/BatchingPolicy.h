@@ -0,0 +1,85 @@
+#pragma once
+
+#include <QtGlobal>
+
+#include <atomic>
+#include <limits>
+
+#include "LatencyEstimator.h"
+
+
+namespace engines
+{
+class BaseTensorEngineSettings;
+}
+
+namespace service
+{
+/**
+ * @brief The BatchingPolicy class - decides how long partial batch can be held
+ * by cost of each batch size measured by latency estimator
+ */
+class BatchingPolicy
+{
+public:
+    BatchingPolicy(engines::BaseTensorEngineSettings const& settings, size_t maxBatches);
+
+    /**
+     * @brief max batches
+     * @return
+     */
+    size_t maxBatches() const;
+
+    /**
+     * @brief count of batches which is enough for forward without holding
+     * @return
+     */
+    size_t targetBatches() const;
+
+    /**
+     * @brief set estimator which is source of batch costs
+     * @param latencyEstimator
+     */
+    void setLatencyEstimator(LatencyEstimatorPtr const& latencyEstimator);
+
+    /**
+     * @brief cost of forward batch size
+     * @param batches - batch size
+     * @return nanoseconds (-1 if not measured)
+     */
+    qint64 batchCost(size_t batches) const;
+
+    /**
+     * @brief record forwarded batch size for fill ratio
+     * @param batches - batch size
+     */
+    void record(size_t batches);
+
+    /**
+     * @brief time for holding partial batch
+     * @param batches - count of pending requests
+     * @param oldestAgeNs - nanoseconds since oldest pending request was pushed
+     * @param deadlineSlackNs - nanoseconds till earliest deadline of pending requests
+     * @return nanoseconds (0 - forward immediately)
+     */
+    qint64 holdNs(size_t batches, qint64 oldestAgeNs,
+                  qint64 deadlineSlackNs = std::numeric_limits<qint64>::max()) const;
+
+    /**
+     * @brief achieved batch fill ratio (average batch size to max batches)
+     * @return ratio in range [0, 1]
+     */
+    double fillRatio() const;
+
+private:
+    size_t m_maxBatches = 1;
+    size_t m_targetBatches = 1;
+    qint64 m_maxWaitNs = 0;
+    qint64 m_latencyBudgetNs = 0;
+
+    LatencyEstimatorPtr m_latencyEstimator = nullptr;
+
+    std::atomic<quint64> m_countBatches{0};
+    std::atomic<quint64> m_countRequests{0};
+};
+}
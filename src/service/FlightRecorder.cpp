@@ -0,0 +1,206 @@
+#include "FlightRecorder.h"
+
+#include <QLoggingCategory>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QHash>
+#include <QFile>
+
+#include <algorithm>
+
+
+namespace service
+{
+Q_LOGGING_CATEGORY(QLC_FLIGHT_RECORDER, "FlightRecorder")
+
+static constexpr auto EVENTS = static_cast<size_t>(FlightRecorder::Event::Count);
+
+/**
+ * Stages of request between two events, shown as nested async slices
+ */
+struct Stage
+{
+    char const* name;
+    FlightRecorder::Event begin;
+    FlightRecorder::Event end;
+};
+
+static constexpr std::array<Stage, 6> STAGES = {{
+    {"request", FlightRecorder::Event::Received, FlightRecorder::Event::Emitted},
+    {"convert_queue", FlightRecorder::Event::Received, FlightRecorder::Event::DecodeStart},
+    {"convert", FlightRecorder::Event::DecodeStart, FlightRecorder::Event::DecodeEnd},
+    {"engine_queue", FlightRecorder::Event::EngineEnqueue, FlightRecorder::Event::BatchFormed},
+    {"batch_load", FlightRecorder::Event::BatchFormed, FlightRecorder::Event::InferStart},
+    {"infer", FlightRecorder::Event::InferStart, FlightRecorder::Event::InferEnd},
+}};
+
+FlightRecorder& FlightRecorder::instance()
+{
+    static FlightRecorder recorder;
+    return recorder;
+}
+
+void FlightRecorder::record(Event event, quint64 id)
+{
+    record(event, id, Clock::now());
+}
+
+void FlightRecorder::record(Event event, quint64 id, std::chrono::steady_clock::time_point time)
+{
+    auto const timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(time - m_epoch).count();
+
+    auto& own = ring();
+    auto const head = own.head.load(std::memory_order_relaxed);
+    auto& slot = own.slots[head % RING_SIZE];
+
+    slot.sequence.store(2 * head + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.id.store(id, std::memory_order_relaxed);
+    slot.timestamp.store(timestamp, std::memory_order_relaxed);
+    slot.event.store(static_cast<quint8>(event), std::memory_order_relaxed);
+    slot.sequence.store(2 * head + 2, std::memory_order_release);
+
+    own.head.store(head + 1, std::memory_order_release);
+}
+
+QByteArray FlightRecorder::chromeTrace() const
+{
+    struct Track
+    {
+        std::array<qint64, EVENTS> timestamps{};
+        std::array<quint32, EVENTS> threads{};
+        std::array<bool, EVENTS> recorded{};
+    };
+
+    QHash<quint64, Track> tracks;
+    for (auto const& record : records())
+    {
+        auto& track = tracks[record.id];
+        auto const event = static_cast<size_t>(record.event);
+        track.timestamps[event] = record.timestamp;
+        track.threads[event] = record.thread;
+        track.recorded[event] = true;
+    }
+
+    QJsonArray events;
+    for (auto it = tracks.cbegin(); it != tracks.cend(); ++it)
+    {
+        auto const& track = it.value();
+        auto const id = QString::number(it.key());
+
+        for (auto const& stage : STAGES)
+        {
+            auto const begin = static_cast<size_t>(stage.begin);
+            auto const end = static_cast<size_t>(stage.end);
+            if (!track.recorded[begin] || !track.recorded[end] || track.timestamps[end] < track.timestamps[begin])
+            {
+                continue;
+            }
+
+            // timestamps of trace are in microseconds
+            for (auto const& [phase, event] : {std::make_pair("b", begin), std::make_pair("e", end)})
+            {
+                events.append(QJsonObject{
+                                  {"name", stage.name},
+                                  {"cat", "request"},
+                                  {"ph", phase},
+                                  {"id", id},
+                                  {"pid", 1},
+                                  {"tid", static_cast<qint64>(track.threads[event])},
+                                  {"ts", track.timestamps[event] / 1000.0},
+                                  {"args", QJsonObject{{"request", id}}}
+                              });
+            }
+        }
+    }
+
+    qCInfo(QLC_FLIGHT_RECORDER) << "Trace of" << tracks.size() << "requests is exported";
+
+    return QJsonDocument(QJsonObject{
+                             {"traceEvents", events},
+                             {"displayTimeUnit", "ms"}
+                         }).toJson(QJsonDocument::Compact);
+}
+
+bool FlightRecorder::dump(QString const& path) const
+{
+    QFile file(path);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate))
+    {
+        qCCritical(QLC_FLIGHT_RECORDER) << "Cannot open file:" << path << "error:" << file.errorString();
+        return false;
+    }
+
+    auto const trace = chromeTrace();
+    if (file.write(trace) != trace.size())
+    {
+        qCCritical(QLC_FLIGHT_RECORDER) << "Cannot write file:" << path << "error:" << file.errorString();
+        return false;
+    }
+
+    qCInfo(QLC_FLIGHT_RECORDER) << "Trace is dumped to" << path;
+    return true;
+}
+
+FlightRecorder::Ring& FlightRecorder::ring()
+{
+    // ring is registered once per thread and lives till the end of process
+    static thread_local Ring* own = nullptr;
+    if (!own)
+    {
+        auto ring = std::make_unique<Ring>();
+        own = ring.get();
+
+        std::unique_lock<std::mutex> lock(m_ringsMutex);
+        ring->thread = static_cast<quint32>(m_rings.size() + 1);
+        m_rings.push_back(std::move(ring));
+    }
+
+    return *own;
+}
+
+std::vector<FlightRecorder::Record> FlightRecorder::records() const
+{
+    std::vector<Record> records;
+
+    std::unique_lock<std::mutex> lock(m_ringsMutex);
+    for (auto const& ring : m_rings)
+    {
+        auto const head = ring->head.load(std::memory_order_acquire);
+        auto const first = head > RING_SIZE ? head - RING_SIZE : 0;
+
+        for (auto n = first; n < head; ++n)
+        {
+            auto const& slot = ring->slots[n % RING_SIZE];
+
+            // slot is skipped if it is overwritten while reading
+            auto const sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence != 2 * n + 2)
+            {
+                continue;
+            }
+
+            Record record;
+            record.id = slot.id.load(std::memory_order_relaxed);
+            record.timestamp = slot.timestamp.load(std::memory_order_relaxed);
+            record.event = static_cast<Event>(slot.event.load(std::memory_order_relaxed));
+            record.thread = ring->thread;
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) != sequence)
+            {
+                continue;
+            }
+
+            records.push_back(record);
+        }
+    }
+
+    std::sort(records.begin(), records.end(), [] (Record const& left, Record const& right) {
+        return left.timestamp < right.timestamp;
+    });
+
+    return records;
+}
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+
+namespace service
+{
+/**
+ * @brief The FlightRecorder class - always-on recorder of request timestamps
+ * each thread writes own ring buffer without locks, oldest events are overwritten,
+ * rings are read on demand and exported as Chrome trace (Perfetto) JSON
+ */
+class FlightRecorder
+{
+public:
+    /**
+     * Points of request in pipeline
+     */
+    enum class Event : quint8
+    {
+        Received,      // request is received by service
+        DecodeStart,   // image convertor started request
+        DecodeEnd,     // image convertor finished request
+        EngineEnqueue, // request is pushed to tensor engine queue
+        BatchFormed,   // request is taken to batch
+        InferStart,    // forward of batch is started
+        InferEnd,      // forward of batch is finished
+        Emitted,       // result or error is sent
+        Count
+    };
+
+    /**
+     * @brief recorder instance
+     * @return
+     */
+    static FlightRecorder& instance();
+
+    /**
+     * @brief record event of request, lock free
+     * @param event
+     * @param id - request id
+     */
+    void record(Event event, quint64 id);
+
+    /**
+     * @brief record event of request happened at time point, lock free
+     * used for events measured by other thread (e.g. end of forward on infer thread)
+     * @param event
+     * @param id - request id
+     * @param time - steady clock time of event
+     */
+    void record(Event event, quint64 id, std::chrono::steady_clock::time_point time);
+
+    /**
+     * @brief recorded events in Chrome trace JSON format,
+     * each request is async track with its stages
+     * @return
+     */
+    QByteArray chromeTrace() const;
+
+    /**
+     * @brief dump recorded events to file in Chrome trace JSON format
+     * @param path - path to file
+     * @return success
+     */
+    bool dump(QString const& path) const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr size_t RING_SIZE = 8192;
+
+    // slot is guarded by sequence: odd while writing
+    struct Slot
+    {
+        std::atomic<quint64> sequence{0};
+        std::atomic<quint64> id{0};
+        std::atomic<qint64> timestamp{0};
+        std::atomic<quint8> event{0};
+    };
+
+    struct alignas(64) Ring
+    {
+        quint32 thread = 0;
+        std::atomic<quint64> head{0};
+        std::array<Slot, RING_SIZE> slots{};
+    };
+
+    struct Record
+    {
+        quint64 id = 0;
+        qint64 timestamp = 0;
+        Event event = Event::Count;
+        quint32 thread = 0;
+    };
+
+private:
+    FlightRecorder() = default;
+
+    Ring& ring();
+    std::vector<Record> records() const;
+
+private:
+    Clock::time_point const m_epoch = Clock::now();
+
+    mutable std::mutex m_ringsMutex{};
+    std::vector<std::unique_ptr<Ring>> m_rings{};
+};
+}
@@ -1,106 +1,70 @@
 #include "ImageConvertorWorker.h"
+#include "FlightRecorder.h"
+#include "Metrics.h"
+#include "utils/ThreadAffinity.h"
 
 #include <QLoggingCategory>
-#include <QRunnable>
+#include <QElapsedTimer>
 
 namespace service
 {
 Q_LOGGING_CATEGORY(QLC_IMAGE_WORKER, "ImageConvertorWorker")
 
-class CommonRunnable : public QRunnable
+/**
+ * @brief The ImageJob struct - request record, recycled after handling
+ */
+struct ImageJob
 {
-public:
-    CommonRunnable(quint64 id, ImageConvertorWorker* worker)
-        : m_id(id)
-        , m_worker(worker)
-    {
-        setAutoDelete(true);
-    }
-
-    qint64 id() const
-    {
-        return m_id;
-    }
-
-    ImageConvertorWorker* worker() const
-    {
-        return m_worker;
-    }
-
-    void run() override
-    {
-        image::ImageConvertorTypeError error = image::ImageConvertorTypeError::NoError;
-        auto const result = getResult(&error);
-
-        if (result)
-        {
-            emit worker()->result(id(), result);
-        }
-        else
-        {
-            emit worker()->error(id(), ImageConvertorWorker::convert(error));
-        }
-        worker()->m_queueSize--;
-    }
-
-protected:
-    virtual common::IEngineInputDataPtr getResult(image::ImageConvertorTypeError* error) = 0;
-
-private:
-    quint64 m_id = 0;
-    ImageConvertorWorker* m_worker = nullptr;
-};
-
-class BinImageRunnable : public CommonRunnable
-{
-public:
-    BinImageRunnable(quint64 id, QByteArray const& data, ImageConvertorWorker* worker)
-        : CommonRunnable(id, worker)
-        , m_data(data)
-    {
-    }
+    quint64 id = 0;
+    RequestOptions options{};
+    QByteArray data{};
+    QString path{};
+    bool fromPath = false;
 
-protected:
-    common::IEngineInputDataPtr getResult(image::ImageConvertorTypeError* error) override
+    void assign(QByteArray const& data)
     {
-        return worker()->imageConvertor()->convert(m_data, error);
+        this->data = data;
+        fromPath = false;
     }
 
-private:
-    QByteArray m_data{};
-};
-
-class PathImageRunnable : public CommonRunnable
-{
-public:
-    PathImageRunnable(quint64 id, QString const& path, ImageConvertorWorker* worker)
-        : CommonRunnable(id, worker)
-        , m_path(path)
+    void assign(QString const& path)
     {
+        this->path = path;
+        fromPath = true;
     }
 
-protected:
-    common::IEngineInputDataPtr getResult(image::ImageConvertorTypeError* error) override
+    void reset()
     {
-        return worker()->imageConvertor()->convert(m_path, error);
+        options = {};
+        data.clear();
+        path.clear();
     }
-
-private:
-    QString m_path{};
 };
 
 ImageConvertorWorker::ImageConvertorWorker(image::IImageConvertorPtr const& imageConvertor,
                                            size_t maxThreads,
+                                           std::vector<int> const& cpus,
                                            QObject* parent)
     : QObject(parent)
     , m_imageConvertor(imageConvertor)
+    , m_cpus(cpus)
 {
-    m_pool.setMaxThreadCount(maxThreads);
+    m_executor = std::make_unique<utils::WorkStealingExecutor<ImageJob, RequestOptions::PRIORITIES>>(
+                maxThreads,
+                [this] (ImageJob* job) { handle(job); },
+                [this] { utils::ThreadAffinity::pinCurrentThread(m_cpus); });
 }
 
 ImageConvertorWorker::~ImageConvertorWorker()
 {
     stop();
+
+    m_executor.reset();
+    ImageJob* job = nullptr;
+    while (m_freeJobs.tryPop(job))
+    {
+        delete job;
+    }
 }
 
 bool ImageConvertorWorker::running() const
@@ -110,12 +74,22 @@ bool ImageConvertorWorker::running() const
 
 size_t ImageConvertorWorker::queueSize() const
 {
-    return m_queueSize;
+    return m_executor->size();
+}
+
+size_t ImageConvertorWorker::queueSize(int priority) const
+{
+    return m_executor->size(priority);
+}
+
+qint64 ImageConvertorWorker::queuedBytes() const
+{
+    return m_queuedBytes;
 }
 
 size_t ImageConvertorWorker::maxThreads() const
 {
-    return m_pool.maxThreadCount();
+    return m_executor->threads();
 }
 
 image::IImageConvertorPtr const& ImageConvertorWorker::imageConvertor() const
@@ -123,6 +97,11 @@ image::IImageConvertorPtr const& ImageConvertorWorker::imageConvertor() const
     return m_imageConvertor;
 }
 
+void ImageConvertorWorker::setLatencyEstimator(LatencyEstimatorPtr const& latencyEstimator)
+{
+    m_latencyEstimator = latencyEstimator;
+}
+
 void ImageConvertorWorker::start()
 {
     if (running())
@@ -136,9 +115,10 @@ void ImageConvertorWorker::start()
         return;
     }
 
-    qCInfo(QLC_IMAGE_WORKER) << "Start requiered, max threads:" << m_pool.maxThreadCount();
+    qCInfo(QLC_IMAGE_WORKER) << "Start requiered, max threads:" << maxThreads();
 
     m_stop = false;
+    m_executor->start();
     setRunning(true);
 }
 
@@ -158,12 +138,12 @@ void ImageConvertorWorker::stop()
     qCInfo(QLC_IMAGE_WORKER) << "Stop requiered";
 
     m_stop = true;
-    m_pool.waitForDone();
+    m_executor->stop();
     setRunning(false);
 }
 
-template <typename Runnuble, typename T>
-void ImageConvertorWorker::push(quint64 id, T const& data)
+template <typename T>
+void ImageConvertorWorker::push(quint64 id, T const& data, RequestOptions const& options)
 {
     if (m_stop)
     {
@@ -172,19 +152,73 @@ void ImageConvertorWorker::push(quint64 id, T const& data)
     }
     else
     {
-        m_queueSize++;
-        m_pool.start(new Runnuble(id, data, this));
+        auto const job = acquireJob();
+        job->id = id;
+        job->options = options;
+        job->assign(data);
+        enqueue(job);
+    }
+}
+
+template <typename T>
+void ImageConvertorWorker::push(QList<quint64> const& ids, QList<T> const& data, QList<RequestOptions> const& options)
+{
+    Q_ASSERT(ids.size() == data.size() && ids.size() == options.size());
+
+    if (m_stop)
+    {
+        qCWarning(QLC_IMAGE_WORKER) << "Reject requests by stop" << ids;
+        for (auto const id : ids)
+        {
+            error(id, SkinCancerDetectorServiceSource::StopService);
+        }
+        return;
+    }
+
+    for (int i = 0; i < ids.size(); ++i)
+    {
+        auto const job = acquireJob();
+        job->id = ids[i];
+        job->options = options[i];
+        job->assign(data[i]);
+        enqueue(job);
     }
 }
 
-void ImageConvertorWorker::push(quint64 id, QByteArray const& data)
+void ImageConvertorWorker::push(quint64 id, QByteArray const& data, RequestOptions const& options)
+{
+    push<QByteArray>(id, data, options);
+}
+
+void ImageConvertorWorker::push(quint64 id, QString const& path, RequestOptions const& options)
+{
+    push<QString>(id, path, options);
+}
+
+void ImageConvertorWorker::push(QList<quint64> const& ids, QList<QByteArray> const& data, QList<RequestOptions> const& options)
 {
-    push<BinImageRunnable>(id, data);
+    push<QByteArray>(ids, data, options);
 }
 
-void ImageConvertorWorker::push(quint64 id, QString const& path)
+void ImageConvertorWorker::push(QList<quint64> const& ids, QList<QString> const& paths, QList<RequestOptions> const& options)
 {
-    push<PathImageRunnable>(id, path);
+    push<QString>(ids, paths, options);
+}
+
+bool ImageConvertorWorker::cancel(quint64 id)
+{
+    auto const job = m_executor->take([id] (ImageJob const* job) { return job->id == id; });
+    if (!job)
+    {
+        return false;
+    }
+
+    qCInfo(QLC_IMAGE_WORKER) << "Request removed from queue" << id;
+
+    m_queuedBytes -= job->data.size();
+    recycleJob(job);
+
+    return true;
 }
 
 void ImageConvertorWorker::setRunning(bool running)
@@ -200,6 +234,64 @@ void ImageConvertorWorker::setRunning(bool running)
     emit runningChanged(m_running);
 }
 
+ImageJob* ImageConvertorWorker::acquireJob()
+{
+    ImageJob* job = nullptr;
+    return m_freeJobs.tryPop(job) ? job : new ImageJob();
+}
+
+void ImageConvertorWorker::recycleJob(ImageJob* job)
+{
+    job->reset();
+    if (!m_freeJobs.tryPush(std::move(job)))
+    {
+        delete job;
+    }
+}
+
+void ImageConvertorWorker::enqueue(ImageJob* job)
+{
+    m_queuedBytes += job->data.size();
+    m_executor->push(job, job->options.priority);
+}
+
+void ImageConvertorWorker::handle(ImageJob* job)
+{
+    if (!job->options.cancelled())
+    {
+        image::ImageConvertorTypeError error = image::ImageConvertorTypeError::NoError;
+        QElapsedTimer timer;
+        FlightRecorder::instance().record(FlightRecorder::Event::DecodeStart, job->id);
+        timer.start();
+        auto const result = job->fromPath ? m_imageConvertor->convert(job->path, &error)
+                                          : m_imageConvertor->convert(job->data, &error);
+        auto const elapsed = timer.nsecsElapsed();
+        FlightRecorder::instance().record(FlightRecorder::Event::DecodeEnd, job->id);
+        if (result && m_latencyEstimator)
+        {
+            m_latencyEstimator->recordImage(elapsed);
+        }
+        Metrics::instance().observe(Metrics::Stage::Convert, elapsed);
+
+        // request can be cancelled while converting, so output is dropped before tensor engine
+        if (job->options.cancelled())
+        {
+            qCDebug(QLC_IMAGE_WORKER) << "Drop cancelled request" << job->id;
+        }
+        else if (result)
+        {
+            emit this->result(job->id, result, job->options);
+        }
+        else
+        {
+            emit this->error(job->id, convert(error));
+        }
+    }
+
+    m_queuedBytes -= job->data.size();
+    recycleJob(job);
+}
+
 SkinCancerDetectorServiceSource::ErrorType ImageConvertorWorker::convert(image::ImageConvertorTypeError type)
 {
     using ICTE = image::ImageConvertorTypeError;
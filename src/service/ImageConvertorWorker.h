@@ -1,13 +1,18 @@
 #pragma once
 
 #include <QObject>
-#include <QThreadPool>
+#include <QList>
 
 #include <atomic>
 #include <memory>
+#include <vector>
 
 #include <rep_SkinCancerDetectorService_source.h>
 #include "image/IImageConvertor.h"
+#include "utils/MpmcRingBuffer.h"
+#include "utils/WorkStealingExecutor.h"
+#include "LatencyEstimator.h"
+#include "RequestOptions.h"
 
 
 namespace image
@@ -17,8 +22,10 @@ enum class ImageConvertorTypeError;
 
 namespace service
 {
+struct ImageJob;
+
 /**
- * @brief The ImageConvertorWorker class - ImageConvertor worker in thread pool
+ * @brief The ImageConvertorWorker class - ImageConvertor worker in work stealing thread pool
  */
 class ImageConvertorWorker : public QObject
 {
@@ -26,11 +33,10 @@ class ImageConvertorWorker : public QObject
 
     Q_PROPERTY(bool running READ running WRITE setRunning NOTIFY runningChanged)
 
-    friend class CommonRunnable;
-
 public:
     explicit ImageConvertorWorker(image::IImageConvertorPtr const& imageConvertor,
                                   size_t maxThreads,
+                                  std::vector<int> const& cpus = {},
                                   QObject* parent = nullptr);
     ~ImageConvertorWorker();
 
@@ -46,6 +52,19 @@ public:
      */
     size_t queueSize() const;
 
+    /**
+     * @brief count of queued requests which will be handled not later than request with priority
+     * @param priority
+     * @return
+     */
+    size_t queueSize(int priority) const;
+
+    /**
+     * @brief bytes of queued image data
+     * @return
+     */
+    qint64 queuedBytes() const;
+
     /**
      * @brief max threads
      * @return
@@ -58,6 +77,13 @@ public:
      */
     image::IImageConvertorPtr const& imageConvertor() const;
 
+    /**
+     * @brief set estimator for recording cost of each conversion
+     * @warning should be called before start
+     * @param latencyEstimator
+     */
+    void setLatencyEstimator(LatencyEstimatorPtr const& latencyEstimator);
+
 public slots:
     /**
      * @brief start wokrer
@@ -74,15 +100,41 @@ public slots:
      * @brief push request
      * @param id - id of requst
      * @param data - image bin data
+     * @param options - scheduling options
      */
-    void push(quint64 id, QByteArray const& data);
+    void push(quint64 id, QByteArray const& data, RequestOptions const& options = {});
 
     /**
      * @brief push request
      * @param id - id of requst
      * @param path - path to image
+     * @param options - scheduling options
      */
-    void push(quint64 id, QString const& path);
+    void push(quint64 id, QString const& path, RequestOptions const& options = {});
+
+    /**
+     * @brief push group of requests at once
+     * @param ids - ids of requsts
+     * @param data - images bin data
+     * @param options - scheduling options of each request
+     */
+    void push(QList<quint64> const& ids, QList<QByteArray> const& data, QList<RequestOptions> const& options);
+
+    /**
+     * @brief push group of requests at once
+     * @param ids - ids of requsts
+     * @param paths - paths to images
+     * @param options - scheduling options of each request
+     */
+    void push(QList<quint64> const& ids, QList<QString> const& paths, QList<RequestOptions> const& options);
+
+    /**
+     * @brief remove not started request from queue
+     * request which is already started is dropped by its cancel flag
+     * @param id - id of requst
+     * @return true if request was removed from queue
+     */
+    bool cancel(quint64 id);
 
 signals:
     /**
@@ -95,8 +147,9 @@ signals:
      * @brief result signal
      * @param id - id of requst
      * @param data - result
+     * @param options - scheduling options
      */
-    void result(quint64 id, common::IEngineInputDataPtr const& data);
+    void result(quint64 id, common::IEngineInputDataPtr const& data, RequestOptions const& options);
 
     /**
      * @brief error signal
@@ -108,17 +161,31 @@ signals:
 private:
     void setRunning(bool running);
 
-    template <typename Runnuble, typename T>
-    void push(quint64 id, T const& data);
+    template <typename T>
+    void push(quint64 id, T const& data, RequestOptions const& options);
+
+    template <typename T>
+    void push(QList<quint64> const& ids, QList<T> const& data, QList<RequestOptions> const& options);
+
+    ImageJob* acquireJob();
+    void recycleJob(ImageJob* job);
+    void enqueue(ImageJob* job);
+    void handle(ImageJob* job);
 
     static SkinCancerDetectorServiceSource::ErrorType convert(image::ImageConvertorTypeError type);
 
 private:
+    static constexpr size_t JOBS_POOL_CAPACITY = 1024;
+
     image::IImageConvertorPtr m_imageConvertor = nullptr;
+    LatencyEstimatorPtr m_latencyEstimator = nullptr;
+    std::vector<int> m_cpus{};
     bool m_running = false;
     bool m_stop = false;
-    std::atomic_size_t m_queueSize = 0;
+    std::atomic<qint64> m_queuedBytes = 0;
 
-    QThreadPool m_pool{};
+    // handled jobs are reused instead of allocation for each request
+    utils::MpmcRingBuffer<ImageJob*> m_freeJobs{JOBS_POOL_CAPACITY};
+    std::unique_ptr<utils::WorkStealingExecutor<ImageJob, RequestOptions::PRIORITIES>> m_executor = nullptr;
 };
 }
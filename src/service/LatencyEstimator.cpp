@@ -0,0 +1,89 @@
+#include "LatencyEstimator.h"
+
+#include <algorithm>
+
+
+namespace service
+{
+LatencyEstimator::LatencyEstimator(size_t maxBatches)
+    : m_maxBatches(std::max<size_t>(maxBatches, 1))
+    , m_batchCosts(m_maxBatches + 1)
+{
+    for (auto& cost : m_batchCosts)
+    {
+        cost = -1;
+    }
+}
+
+size_t LatencyEstimator::maxBatches() const
+{
+    return m_maxBatches;
+}
+
+qint64 LatencyEstimator::imageCost() const
+{
+    return m_imageCost.load(std::memory_order_relaxed);
+}
+
+void LatencyEstimator::recordImage(qint64 nsecs)
+{
+    if (nsecs >= 0)
+    {
+        update(m_imageCost, nsecs);
+    }
+}
+
+qint64 LatencyEstimator::batchCost(size_t batches) const
+{
+    batches = std::clamp<size_t>(batches, 1, m_maxBatches);
+
+    auto const cost = m_batchCosts[batches].load(std::memory_order_relaxed);
+    if (cost >= 0)
+    {
+        return cost;
+    }
+
+    // bigger batch is never cheaper, so nearest bigger measured size is upper bound
+    for (auto b = batches + 1; b <= m_maxBatches; ++b)
+    {
+        auto const bigger = m_batchCosts[b].load(std::memory_order_relaxed);
+        if (bigger >= 0)
+        {
+            return bigger;
+        }
+    }
+
+    // scale nearest smaller measured size linearly
+    for (auto b = batches - 1; b > 0; --b)
+    {
+        auto const smaller = m_batchCosts[b].load(std::memory_order_relaxed);
+        if (smaller >= 0)
+        {
+            return smaller * static_cast<qint64>(batches) / static_cast<qint64>(b);
+        }
+    }
+
+    return -1;
+}
+
+void LatencyEstimator::recordBatch(size_t batches, qint64 nsecs)
+{
+    if (batches == 0 || batches > m_maxBatches || nsecs < 0)
+    {
+        return;
+    }
+
+    update(m_batchCosts[batches], nsecs);
+}
+
+void LatencyEstimator::update(std::atomic<qint64>& value, qint64 nsecs)
+{
+    auto current = value.load(std::memory_order_relaxed);
+    qint64 next = 0;
+    do
+    {
+        next = current < 0 ? nsecs : static_cast<qint64>(current + SMOOTHING * (nsecs - current));
+    }
+    while (!value.compare_exchange_weak(current, next, std::memory_order_relaxed));
+}
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <QtGlobal>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+
+namespace service
+{
+/**
+ * @brief The LatencyEstimator class - continuously updated latency of pipeline stages
+ * by real measurements, thread safe and lock free
+ */
+class LatencyEstimator
+{
+public:
+    explicit LatencyEstimator(size_t maxBatches);
+
+    /**
+     * @brief max batches of cost table
+     * @return
+     */
+    size_t maxBatches() const;
+
+    /**
+     * @brief smoothed cost of converting one image
+     * @return nanoseconds (-1 if not measured)
+     */
+    qint64 imageCost() const;
+
+    /**
+     * @brief record measured cost of converting one image
+     * @param nsecs - elapsed nanoseconds
+     */
+    void recordImage(qint64 nsecs);
+
+    /**
+     * @brief smoothed cost of forward batch size,
+     * not measured size is taken from nearest measured size
+     * @param batches - batch size
+     * @return nanoseconds (-1 if nothing is measured)
+     */
+    qint64 batchCost(size_t batches) const;
+
+    /**
+     * @brief record measured cost of forward batch size
+     * @param batches - batch size
+     * @param nsecs - elapsed nanoseconds
+     */
+    void recordBatch(size_t batches, qint64 nsecs);
+
+private:
+    static void update(std::atomic<qint64>& value, qint64 nsecs);
+
+private:
+    static constexpr auto SMOOTHING = 0.1;
+
+    size_t m_maxBatches = 1;
+    std::atomic<qint64> m_imageCost{-1};
+    std::vector<std::atomic<qint64>> m_batchCosts;
+};
+
+using LatencyEstimatorPtr = std::shared_ptr<LatencyEstimator>;
+}
@@ -0,0 +1,206 @@
+#include "Metrics.h"
+
+#include <QMetaEnum>
+
+#include <algorithm>
+
+
+namespace service
+{
+static constexpr auto PREFIX = "skin_cancer_detector_";
+
+// each counter is written only by owner thread of shard
+template <typename T>
+static void add(std::atomic<T>& counter, T value)
+{
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+static QByteArray number(double value)
+{
+    return QByteArray::number(value, 'g', 12);
+}
+
+static QByteArray stageName(Metrics::Stage stage)
+{
+    switch (stage) {
+    case Metrics::Stage::Convert:
+        return "convert";
+    case Metrics::Stage::EngineQueue:
+        return "engine_queue";
+    case Metrics::Stage::Infer:
+        return "infer";
+    case Metrics::Stage::Total:
+        return "total";
+    default:
+        break;
+    }
+
+    return "unknown";
+}
+
+Metrics& Metrics::instance()
+{
+    static Metrics metrics;
+    return metrics;
+}
+
+void Metrics::observe(Stage stage, qint64 nsecs)
+{
+    observe(shard().latency[static_cast<size_t>(stage)], LATENCY_BUCKETS, nsecs / 1e9);
+}
+
+void Metrics::observeBatch(size_t batches, qint64 nsecs)
+{
+    auto& own = shard();
+    observe(own.batches, BATCH_BUCKETS, static_cast<double>(batches));
+    add<quint64>(own.engineBusyNs, static_cast<quint64>(std::max<qint64>(nsecs, 0)));
+}
+
+void Metrics::countOutcome(SkinCancerDetectorServiceSource::ErrorType type)
+{
+    auto const index = std::min<size_t>(static_cast<size_t>(type), ERROR_TYPES - 1);
+    add<quint64>(shard().outcomes[index], 1);
+}
+
+void Metrics::countCancelled()
+{
+    add<quint64>(shard().cancelled, 1);
+}
+
+QByteArray Metrics::exposition(int imageQueueSize, int tensorQueueSize)
+{
+    std::vector<Shard const*> shards;
+    {
+        std::unique_lock<std::mutex> lock(m_shardsMutex);
+        for (auto const& shard : m_shards)
+        {
+            shards.push_back(shard.get());
+        }
+    }
+
+    QByteArray out;
+
+    // queue depths
+    out += QByteArray("# HELP ") + PREFIX + "queue_depth Count of queued requests by stage\n";
+    out += QByteArray("# TYPE ") + PREFIX + "queue_depth gauge\n";
+    out += QByteArray(PREFIX) + "queue_depth{stage=\"convert\"} " + QByteArray::number(imageQueueSize) + "\n";
+    out += QByteArray(PREFIX) + "queue_depth{stage=\"engine\"} " + QByteArray::number(tensorQueueSize) + "\n";
+
+    // latency by stage
+    out += QByteArray("# HELP ") + PREFIX + "stage_latency_seconds Latency of request by stage\n";
+    out += QByteArray("# TYPE ") + PREFIX + "stage_latency_seconds histogram\n";
+    for (size_t stage = 0; stage < STAGES; ++stage)
+    {
+        std::vector<Histogram<LATENCY_BUCKETS.size()> const*> histograms;
+        for (auto const shard : shards)
+        {
+            histograms.push_back(&shard->latency[stage]);
+        }
+        writeHistogram(out, QByteArray(PREFIX) + "stage_latency_seconds",
+                       "stage=\"" + stageName(static_cast<Stage>(stage)) + "\"", LATENCY_BUCKETS, histograms);
+    }
+
+    // batch sizes
+    {
+        std::vector<Histogram<BATCH_BUCKETS.size()> const*> histograms;
+        for (auto const shard : shards)
+        {
+            histograms.push_back(&shard->batches);
+        }
+        out += QByteArray("# HELP ") + PREFIX + "batch_size Size of forwarded batches\n";
+        out += QByteArray("# TYPE ") + PREFIX + "batch_size histogram\n";
+        writeHistogram(out, QByteArray(PREFIX) + "batch_size", {}, BATCH_BUCKETS, histograms);
+    }
+
+    // outcomes, requests per second is rate of counter
+    out += QByteArray("# HELP ") + PREFIX + "requests_total Count of handled requests by outcome and error type\n";
+    out += QByteArray("# TYPE ") + PREFIX + "requests_total counter\n";
+    auto const errorTypes = QMetaEnum::fromType<SkinCancerDetectorServiceSource::ErrorType>();
+    for (size_t type = 0; type < ERROR_TYPES; ++type)
+    {
+        quint64 count = 0;
+        for (auto const shard : shards)
+        {
+            count += shard->outcomes[type].load(std::memory_order_relaxed);
+        }
+
+        // error label is empty for outcomes without error
+        auto const name = errorTypes.valueToKey(static_cast<int>(type));
+        out += QByteArray(PREFIX) + "requests_total{outcome=\"" + (type == 0 ? "success" : "error")
+                + "\",error=\"" + (type == 0 ? "" : (name ? name : "Unknown")) + "\"} " + QByteArray::number(count) + "\n";
+    }
+
+    quint64 cancelled = 0;
+    quint64 engineBusyNs = 0;
+    for (auto const shard : shards)
+    {
+        cancelled += shard->cancelled.load(std::memory_order_relaxed);
+        engineBusyNs += shard->engineBusyNs.load(std::memory_order_relaxed);
+    }
+    out += QByteArray(PREFIX) + "requests_total{outcome=\"cancelled\",error=\"\"} " + QByteArray::number(cancelled) + "\n";
+
+    // engine busy time, utilization is rate of counter per replica
+    out += QByteArray("# HELP ") + PREFIX + "engine_busy_seconds_total Time of tensor engines forwarding batches\n";
+    out += QByteArray("# TYPE ") + PREFIX + "engine_busy_seconds_total counter\n";
+    out += QByteArray(PREFIX) + "engine_busy_seconds_total " + number(engineBusyNs / 1e9) + "\n";
+
+    return out;
+}
+
+Metrics::Shard& Metrics::shard()
+{
+    // shard is registered once per thread and lives till the end of process
+    static thread_local Shard* own = nullptr;
+    if (!own)
+    {
+        auto shard = std::make_unique<Shard>();
+        own = shard.get();
+
+        std::unique_lock<std::mutex> lock(m_shardsMutex);
+        m_shards.push_back(std::move(shard));
+    }
+
+    return *own;
+}
+
+template <size_t N>
+void Metrics::observe(Histogram<N>& histogram, std::array<double, N> const& bounds, double value)
+{
+    auto const bucket = static_cast<size_t>(std::lower_bound(bounds.begin(), bounds.end(), value) - bounds.begin());
+    add<quint64>(histogram.buckets[bucket], 1);
+    add<quint64>(histogram.count, 1);
+    add<double>(histogram.sum, value);
+}
+
+template <size_t N>
+void Metrics::writeHistogram(QByteArray& out, QByteArray const& name, QByteArray const& labels,
+                             std::array<double, N> const& bounds, std::vector<Histogram<N> const*> const& histograms)
+{
+    auto const separator = labels.isEmpty() ? QByteArray() : QByteArray(",");
+
+    quint64 cumulative = 0;
+    for (size_t bucket = 0; bucket <= N; ++bucket)
+    {
+        for (auto const histogram : histograms)
+        {
+            cumulative += histogram->buckets[bucket].load(std::memory_order_relaxed);
+        }
+
+        auto const le = bucket < N ? number(bounds[bucket]) : QByteArray("+Inf");
+        out += name + "_bucket{" + labels + separator + "le=\"" + le + "\"} " + QByteArray::number(cumulative) + "\n";
+    }
+
+    quint64 count = 0;
+    double sum = 0;
+    for (auto const histogram : histograms)
+    {
+        count += histogram->count.load(std::memory_order_relaxed);
+        sum += histogram->sum.load(std::memory_order_relaxed);
+    }
+
+    auto const braces = labels.isEmpty() ? QByteArray() : "{" + labels + "}";
+    out += name + "_sum" + braces + " " + number(sum) + "\n";
+    out += name + "_count" + braces + " " + QByteArray::number(count) + "\n";
+}
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <QByteArray>
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <rep_SkinCancerDetectorService_source.h>
+
+
+namespace service
+{
+/**
+ * @brief The Metrics class - pipeline metrics in Prometheus text format
+ * each thread writes only own shard of counters, so collection is lock free,
+ * shards are summed only on exposition
+ */
+class Metrics
+{
+public:
+    /**
+     * Stages of request for latency histogram
+     */
+    enum class Stage
+    {
+        Convert,     // image decoding and preprocessing
+        EngineQueue, // waiting in tensor engine queue till batch formation
+        Infer,       // forward of batch
+        Total,       // from receiving till result
+        Count
+    };
+
+    /**
+     * @brief metrics instance
+     * @return
+     */
+    static Metrics& instance();
+
+    /**
+     * @brief observe latency of stage
+     * @param stage
+     * @param nsecs - nanoseconds
+     */
+    void observe(Stage stage, qint64 nsecs);
+
+    /**
+     * @brief observe size of forwarded batch and time of engine was busy by it
+     * @param batches - batch size
+     * @param nsecs - nanoseconds of forward
+     */
+    void observeBatch(size_t batches, qint64 nsecs);
+
+    /**
+     * @brief count outcome of request
+     * @param type - NoError for success
+     */
+    void countOutcome(SkinCancerDetectorServiceSource::ErrorType type);
+
+    /**
+     * @brief count cancelled request
+     */
+    void countCancelled();
+
+    /**
+     * @brief metrics in Prometheus text format
+     * @param imageQueueSize - count of requests in image convertor queue
+     * @param tensorQueueSize - count of requests in tensor engine queue
+     * @return
+     */
+    QByteArray exposition(int imageQueueSize, int tensorQueueSize);
+
+private:
+    static constexpr size_t ERROR_TYPES = SkinCancerDetectorServiceSource::Overloaded + 1;
+    static constexpr size_t STAGES = static_cast<size_t>(Stage::Count);
+    static constexpr std::array<double, 14> LATENCY_BUCKETS = {0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05,
+                                                               0.1, 0.25, 0.5, 1, 2.5, 5, 10};
+    static constexpr std::array<double, 8> BATCH_BUCKETS = {1, 2, 4, 8, 16, 32, 64, 128};
+
+    template <size_t N>
+    struct Histogram
+    {
+        // last bucket is +Inf
+        std::array<std::atomic<quint64>, N + 1> buckets{};
+        std::atomic<quint64> count{0};
+        std::atomic<double> sum{0};
+    };
+
+    struct alignas(64) Shard
+    {
+        std::array<Histogram<LATENCY_BUCKETS.size()>, STAGES> latency{};
+        Histogram<BATCH_BUCKETS.size()> batches{};
+        std::array<std::atomic<quint64>, ERROR_TYPES> outcomes{};
+        std::atomic<quint64> cancelled{0};
+        std::atomic<quint64> engineBusyNs{0};
+    };
+
+private:
+    Metrics() = default;
+
+    Shard& shard();
+
+    template <size_t N>
+    static void observe(Histogram<N>& histogram, std::array<double, N> const& bounds, double value);
+
+    template <size_t N>
+    static void writeHistogram(QByteArray& out, QByteArray const& name, QByteArray const& labels,
+                               std::array<double, N> const& bounds, std::vector<Histogram<N> const*> const& histograms);
+
+private:
+    std::mutex m_shardsMutex{};
+    std::vector<std::unique_ptr<Shard>> m_shards{};
+};
+}
@@ -0,0 +1,77 @@
+#include "MetricsServer.h"
+
+#include <QLoggingCategory>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+
+namespace service
+{
+Q_LOGGING_CATEGORY(QLC_METRICS_SERVER, "MetricsServer")
+
+static constexpr auto METRICS_PATH = "/metrics";
+
+MetricsServer::MetricsServer(Collector const& collector, QObject* parent)
+    : QObject(parent)
+    , m_collector(collector)
+    , m_server(new QTcpServer(this))
+{
+    connect(m_server, &QTcpServer::newConnection, this, &MetricsServer::onNewConnection);
+}
+
+bool MetricsServer::listen(quint16 port)
+{
+    if (!m_server->listen(QHostAddress::LocalHost, port))
+    {
+        qCCritical(QLC_METRICS_SERVER) << "Cannot listen port" << port << "error:" << m_server->errorString();
+        return false;
+    }
+
+    qCInfo(QLC_METRICS_SERVER) << "Metrics are available on" << QString("http://localhost:%1%2").arg(port).arg(METRICS_PATH);
+    return true;
+}
+
+void MetricsServer::onNewConnection()
+{
+    while (auto const socket = m_server->nextPendingConnection())
+    {
+        connect(socket, &QTcpSocket::disconnected, socket, &QTcpSocket::deleteLater);
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket] {
+            // request is replied when its header is received completely
+            if (socket->bytesAvailable() > 0 && socket->peek(socket->bytesAvailable()).contains("\r\n\r\n"))
+            {
+                reply(socket);
+            }
+        });
+    }
+}
+
+void MetricsServer::reply(QTcpSocket* socket)
+{
+    auto const request = socket->readAll();
+    auto const requestLine = request.left(request.indexOf("\r\n")).split(' ');
+    auto const path = requestLine.size() > 1 ? requestLine[1] : QByteArray();
+
+    QByteArray status = "200 OK";
+    QByteArray body;
+    if (requestLine.first() != "GET")
+    {
+        status = "405 Method Not Allowed";
+    }
+    else if (path != METRICS_PATH && path != "/")
+    {
+        status = "404 Not Found";
+    }
+    else
+    {
+        body = m_collector();
+    }
+
+    socket->write("HTTP/1.0 " + status + "\r\n"
+                  "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                  "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+                  "Connection: close\r\n"
+                  "\r\n" + body);
+    socket->disconnectFromHost();
+}
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <QObject>
+#include <QByteArray>
+
+#include <functional>
+
+
+class QTcpServer;
+class QTcpSocket;
+
+namespace service
+{
+/**
+ * @brief The MetricsServer class - HTTP endpoint on localhost for scraping metrics by Prometheus
+ */
+class MetricsServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    using Collector = std::function<QByteArray()>;
+
+    /**
+     * @param collector - returns metrics in Prometheus text format, called in thread of server
+     */
+    explicit MetricsServer(Collector const& collector, QObject* parent = nullptr);
+
+    /**
+     * @brief start listening on localhost
+     * @param port
+     * @return success
+     */
+    bool listen(quint16 port);
+
+private slots:
+    void onNewConnection();
+
+private:
+    void reply(QTcpSocket* socket);
+
+private:
+    Collector m_collector{};
+    QTcpServer* m_server = nullptr;
+};
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <QtGlobal>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+
+namespace service
+{
+/**
+ * @brief The RequestOptions struct - scheduling options of request
+ */
+struct RequestOptions
+{
+    using Clock = std::chrono::steady_clock;
+    using CancelFlag = std::shared_ptr<std::atomic_bool>;
+
+    /**
+     * Count of priority levels (see SkinCancerDetectorService::Priority)
+     */
+    static constexpr int PRIORITIES = 4;
+    static constexpr int DEFAULT_PRIORITY = 1;
+
+    int priority = DEFAULT_PRIORITY;
+    Clock::time_point deadline = Clock::time_point::max();
+    Clock::time_point received{};
+    CancelFlag cancelFlag = nullptr;
+
+    /**
+     * @brief request was cancelled by client
+     * @return
+     */
+    bool cancelled() const
+    {
+        return cancelFlag && cancelFlag->load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief request has deadline
+     * @return
+     */
+    bool hasDeadline() const
+    {
+        return deadline != Clock::time_point::max();
+    }
+
+    /**
+     * @brief request should be scheduled before other: higher priority, then earlier deadline
+     * @param other
+     * @return
+     */
+    bool before(RequestOptions const& other) const
+    {
+        return priority != other.priority ? priority > other.priority : deadline < other.deadline;
+    }
+};
+
+/**
+ * @brief The QueueCounter class - thread safe count of queued requests by priority
+ */
+class QueueCounter
+{
+public:
+    /**
+     * @brief increment count
+     * @param priority - priority of request
+     * @return total count after increment
+     */
+    int increment(int priority)
+    {
+        m_counts[index(priority)]++;
+        return ++m_total;
+    }
+
+    /**
+     * @brief decrement count
+     * @param priority - priority of request
+     * @return total count after decrement
+     */
+    int decrement(int priority)
+    {
+        m_counts[index(priority)]--;
+        return --m_total;
+    }
+
+    /**
+     * @brief total count
+     * @return
+     */
+    int size() const
+    {
+        return m_total.load();
+    }
+
+    /**
+     * @brief count of requests which will be scheduled not later than request with priority
+     * @param priority - min priority
+     * @return
+     */
+    int size(int priority) const
+    {
+        int size = 0;
+        for (int p = index(priority); p < RequestOptions::PRIORITIES; ++p)
+        {
+            size += m_counts[p].load();
+        }
+
+        return size;
+    }
+
+private:
+    static int index(int priority)
+    {
+        return qBound(0, priority, RequestOptions::PRIORITIES - 1);
+    }
+
+private:
+    std::array<std::atomic_int, RequestOptions::PRIORITIES> m_counts{};
+    std::atomic_int m_total = 0;
+};
+}
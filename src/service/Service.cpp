@@ -2,12 +2,20 @@
 
 #include "utils/ServiceLocator.h"
 #include "utils/SettingsReader.h"
-#include "TensorEngineWorker.h"
+#include "utils/ThreadAffinity.h"
+#include "TensorEngineDispatcher.h"
 #include "ImageConvertorWorker.h"
+#include "FlightRecorder.h"
+#include "Metrics.h"
+#include "MetricsServer.h"
 
 #include <QRemoteObjectHost>
+#include <QDateTime>
+#include <QDir>
 #include <QLoggingCategory>
 
+#include <algorithm>
+
 
 namespace service
 {
@@ -15,10 +23,28 @@ Q_LOGGING_CATEGORY(QLC_SERVICE, "Service")
 
 static utils::ServiceLocator serviceLocator;
 
+static qint64 requestBytes(QByteArray const& image)
+{
+    return image.size();
+}
+
+static qint64 requestBytes(QString const&)
+{
+    return 0;
+}
+
+static_assert(RequestOptions::PRIORITIES == Service::Urgent + 1, "Count of priorities mismatch");
+static_assert(RequestOptions::DEFAULT_PRIORITY == Service::Normal, "Default priority mismatch");
+
 
 Service::Service(QObject* parent)
     : SkinCancerDetectorServiceSource(parent)
 {
+    qRegisterMetaType<QList<SkinCancerDetectorRequestInfo>>();
+    qRegisterMetaTypeStreamOperators<QList<SkinCancerDetectorRequestInfo>>();
+    qRegisterMetaType<QList<SkinCancerDetectorRequestResult>>();
+    qRegisterMetaTypeStreamOperators<QList<SkinCancerDetectorRequestResult>>();
+
     serviceLocator.init();
     createComponents();
 }
@@ -26,53 +52,167 @@ Service::Service(QObject* parent)
 Service::~Service()
 {
     m_imageConvertorWorker->stop();
-    m_tensorEngineWorker->stop();
+    m_tensorEngineDispatcher->stop();
 }
 
 void Service::start()
 {
     m_imageConvertorWorker->start();
-    m_tensorEngineWorker->start();
+    m_tensorEngineDispatcher->start();
 }
 
 SkinCancerDetectorRequestInfo Service::request(QByteArray image)
+{
+    return request(image, Normal, 0);
+}
+
+SkinCancerDetectorRequestInfo Service::request(QString imagePath)
+{
+    return request(imagePath, Normal, 0);
+}
+
+SkinCancerDetectorRequestInfo Service::request(QByteArray image, Priority priority, qint64 deadlineMs)
 {
     auto const id = getRequestId();
-    auto const estimates = estimateNextRequest();
+    FlightRecorder::instance().record(FlightRecorder::Event::Received, id);
+    auto const options = makeOptions(priority, deadlineMs);
+    auto const estimates = estimateNextRequest(options.priority);
 
-    qCInfo(QLC_SERVICE) << "Request received:" << id << "data size" << image.size() << "estimates" << estimates;
+    qCInfo(QLC_SERVICE) << "Request received:" << id << "data size" << image.size()
+                        << "priority" << QMetaEnum::fromType<Priority>().key(priority)
+                        << "deadline ms" << deadlineMs << "estimates" << estimates;
 
-    m_imageConvertorWorker->push(id, image);
+    if (!admit(estimates, image.size()))
+    {
+        return reject(id);
+    }
+
+    m_cancelFlags.insert(id, options.cancelFlag);
+    m_imageConvertorWorker->push(id, image, options);
 
     return SkinCancerDetectorRequestInfo{id, estimates};
 }
 
-SkinCancerDetectorRequestInfo Service::request(QString imagePath)
+SkinCancerDetectorRequestInfo Service::request(QString imagePath, Priority priority, qint64 deadlineMs)
 {
     auto const id = getRequestId();
-    auto const estimates = estimateNextRequest();
+    FlightRecorder::instance().record(FlightRecorder::Event::Received, id);
+    auto const options = makeOptions(priority, deadlineMs);
+    auto const estimates = estimateNextRequest(options.priority);
+
+    qCInfo(QLC_SERVICE) << "Request received:" << id << "image path" << imagePath
+                        << "priority" << QMetaEnum::fromType<Priority>().key(priority)
+                        << "deadline ms" << deadlineMs << "estimates" << estimates;
 
-    qCInfo(QLC_SERVICE) << "Request received:" << id << "image path" << imagePath << "estimates" << estimates;
+    if (!admit(estimates, 0))
+    {
+        return reject(id);
+    }
 
-    m_imageConvertorWorker->push(id, imagePath);
+    m_cancelFlags.insert(id, options.cancelFlag);
+    m_imageConvertorWorker->push(id, imagePath, options);
 
     return SkinCancerDetectorRequestInfo{id, estimates};
 }
 
+QList<SkinCancerDetectorRequestInfo> Service::request(QList<QByteArray> images)
+{
+    return request(images, Normal, 0);
+}
+
+QList<SkinCancerDetectorRequestInfo> Service::request(QList<QString> imagePaths)
+{
+    return request(imagePaths, Normal, 0);
+}
+
+QList<SkinCancerDetectorRequestInfo> Service::request(QList<QByteArray> images, Priority priority, qint64 deadlineMs)
+{
+    return requestGroup(images, priority, deadlineMs);
+}
+
+QList<SkinCancerDetectorRequestInfo> Service::request(QList<QString> imagePaths, Priority priority, qint64 deadlineMs)
+{
+    return requestGroup(imagePaths, priority, deadlineMs);
+}
+
+bool Service::cancel(quint64 id)
+{
+    auto const cancelFlag = m_cancelFlags.take(id);
+    if (!cancelFlag)
+    {
+        qCInfo(QLC_SERVICE) << "Cannot cancel unknown or handled request, id:" << id;
+        return false;
+    }
+
+    // started stages drop request by flag, not started is removed from queue
+    *cancelFlag = true;
+    m_imageConvertorWorker->cancel(id);
+    Metrics::instance().countCancelled();
+
+    qCInfo(QLC_SERVICE) << "Request cancelled, id:" << id;
+
+    return true;
+}
+
+QString Service::dumpTrace()
+{
+    auto const path = QDir::current().absoluteFilePath(
+                QString("trace_%1.json").arg(QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss_zzz")));
+
+    return FlightRecorder::instance().dump(path) ? path : QString();
+}
+
 void Service::onSuccess(quint64 id, float positive, float negative)
 {
+    if (!m_cancelFlags.remove(id))
+    {
+        qCDebug(QLC_SERVICE) << "Drop result of cancelled request, id:" << id;
+        return;
+    }
+
     qCInfo(QLC_SERVICE) << "Request handled successfully, id:" << id << "positive:" << positive << "negative:" << negative;
+    Metrics::instance().countOutcome(NoError);
+    FlightRecorder::instance().record(FlightRecorder::Event::Emitted, id);
 
+    // each client listens to per item or coalesced signal, so both are sent
     emit resultReady(id, SkinCancerDetectorResult{positive, negative});
+
+    m_results.append(SkinCancerDetectorRequestResult{id, positive, negative});
+    if (!m_resultsFlushTimer.isActive())
+    {
+        m_resultsFlushTimer.start();
+    }
 }
 
 void Service::onError(quint64 id, ErrorType type)
 {
+    if (!m_cancelFlags.remove(id))
+    {
+        qCDebug(QLC_SERVICE) << "Drop error of cancelled request, id:" << id;
+        return;
+    }
+
     qCInfo(QLC_SERVICE) << "Request was failed, id:" << id << "type:" << QMetaEnum::fromType<ErrorType>().key(type);
+    Metrics::instance().countOutcome(type);
+    FlightRecorder::instance().record(FlightRecorder::Event::Emitted, id);
 
     emit resultFailed(id, type);
 }
 
+void Service::flushResults()
+{
+    m_resultsFlushTimer.stop();
+    if (m_results.isEmpty())
+    {
+        return;
+    }
+
+    qCDebug(QLC_SERVICE) << "Flush results:" << m_results.size();
+
+    emit resultsReady(m_results);
+    m_results.clear();
+}
+
 void Service::createComponents()
 {
     utils::SettingsReader settingsReader;
@@ -88,21 +228,29 @@ void Service::createComponents()
 
     serviceLocator.setTensorEngineType(settings->tensor.type());
 
-    // create tensor engine
-    auto tensorEngine = serviceLocator.createTensorEngine();
-    if (!tensorEngine)
+    // create tensor engine replicas
+    QList<engines::ITensorEnginePtr> tensorEngines;
+    for (size_t i = 0; i < settings->tensor.replicas(); ++i)
     {
-        auto const message = QString("Cannot create tensor engine by type: %1").arg(settings->tensor.type());
-        qCCritical(QLC_SERVICE) << qPrintable(message);
-        throw std::runtime_error(qPrintable(message));
-    }
-    else if (!tensorEngine->load(settings->tensor))
-    {
-        auto const message = "Cannot load tensor engine settings";
-        qCCritical(QLC_SERVICE) << message;
-        throw std::runtime_error(message);
+        auto tensorEngine = serviceLocator.createTensorEngine();
+        if (!tensorEngine)
+        {
+            auto const message = QString("Cannot create tensor engine by type: %1").arg(settings->tensor.type());
+            qCCritical(QLC_SERVICE) << qPrintable(message);
+            throw std::runtime_error(qPrintable(message));
+        }
+        else if (!tensorEngine->load(settings->tensor))
+        {
+            auto const message = "Cannot load tensor engine settings";
+            qCCritical(QLC_SERVICE) << message;
+            throw std::runtime_error(message);
+        }
+
+        tensorEngines.append(tensorEngine);
     }
 
+    auto const& tensorEngine = tensorEngines.first();
+
     settings->image.setWidth(tensorEngine->inputWidth());
     settings->image.setHeight(tensorEngine->inputHeight());
     settings->image.setChannels(tensorEngine->inputChannels());
@@ -122,12 +270,16 @@ void Service::createComponents()
     }
 
     // setup service
-    setupService(settings->service, tensorEngine, imageConvertor);
+    setupService(settings->service, settings->tensor, tensorEngines, imageConvertor);
+
+    // forward of estimate runs on infer thread of first replica with its threads budget and cpus
+    m_tensorEngineDispatcher->prepareEngines();
     estimate(imageConvertor.get(), tensorEngine.get());
 }
 
 void Service::setupService(ServiceSettings const& settings,
-                           engines::ITensorEnginePtr const& tensorEngine,
+                           engines::BaseTensorEngineSettings const& tensorSettings,
+                           QList<engines::ITensorEnginePtr> const& tensorEngines,
                            image::IImageConvertorPtr const& imageConvertor)
 {
     if (!settings.valid())
@@ -137,19 +289,49 @@ void Service::setupService(ServiceSettings const& settings,
         throw std::runtime_error(message);
     }
 
+    m_settings = settings;
+
+    // results of one engine batch are delivered by queued signals in one event loop iteration
+    m_resultsFlushTimer.setSingleShot(true);
+    m_resultsFlushTimer.setTimerType(Qt::PreciseTimer);
+    m_resultsFlushTimer.setInterval(settings.resultsFlushMs());
+    connect(&m_resultsFlushTimer, &QTimer::timeout, this, &Service::flushResults);
+
     // create image convertor worker
+    auto const cpus = utils::ThreadAffinity::parse(settings.imageConvertorCpus());
     auto const maxThreads = settings.maxImageConvertorThreads() > 0
             ? settings.maxImageConvertorThreads()
-            : std::thread::hardware_concurrency();
-    m_imageConvertorWorker = new ImageConvertorWorker(imageConvertor, maxThreads, this);
+            : (cpus.empty() ? std::thread::hardware_concurrency() : cpus.size());
+    m_imageConvertorWorker = new ImageConvertorWorker(imageConvertor, maxThreads, cpus, this);
+
+    // create tensor engine workers
+    m_tensorEngineDispatcher = new TensorEngineDispatcher(tensorEngines, tensorSettings, this);
 
-    // create tensor engine worker
-    m_tensorEngineWorker = new TensorEngineWorker(tensorEngine, this);
+    // estimates are updated by real measurements of all workers
+    m_latencyEstimator = std::make_shared<LatencyEstimator>(m_tensorEngineDispatcher->maxBatches());
+    m_imageConvertorWorker->setLatencyEstimator(m_latencyEstimator);
+    m_tensorEngineDispatcher->setLatencyEstimator(m_latencyEstimator);
 
-    connect(m_imageConvertorWorker, &ImageConvertorWorker::result, m_tensorEngineWorker, &TensorEngineWorker::push, Qt::DirectConnection);
+    connect(m_imageConvertorWorker, &ImageConvertorWorker::result, m_tensorEngineDispatcher, &TensorEngineDispatcher::push, Qt::DirectConnection);
     connect(m_imageConvertorWorker, &ImageConvertorWorker::error, this, &Service::onError);
-    connect(m_tensorEngineWorker, &TensorEngineWorker::result, this, &Service::onSuccess);
-    connect(m_tensorEngineWorker, &TensorEngineWorker::error, this, &Service::onError);
+    connect(m_tensorEngineDispatcher, &TensorEngineDispatcher::result, this, &Service::onSuccess);
+    connect(m_tensorEngineDispatcher, &TensorEngineDispatcher::error, this, &Service::onError);
+
+    // enable metrics endpoint
+    if (settings.metricsPort() > 0)
+    {
+        auto const metricsServer = new MetricsServer([this] {
+            return Metrics::instance().exposition(static_cast<int>(m_imageConvertorWorker->queueSize()),
+                                                  m_tensorEngineDispatcher->queueSize());
+        }, this);
+
+        if (!metricsServer->listen(static_cast<quint16>(settings.metricsPort())))
+        {
+            auto const message = "Cannot enable metrics endpoint";
+            qCCritical(QLC_SERVICE) << message;
+            throw std::runtime_error(message);
+        }
+    }
 
     // enable remoting
     enableRemoting(settings);
@@ -172,40 +354,178 @@ void Service::enableRemoting(ServiceSettings const& settings)
     qCInfo(QLC_SERVICE) << "Remoting enabled successfully";
 }
 
-void Service::estimate(common::IEstimated* imageConvertor, common::IEstimated* tensorEngine)
+void Service::estimate(common::IEstimated* imageConvertor, engines::ITensorEngine* tensorEngine)
 {
-    m_imageConvertorEstimate = imageConvertor->estimate();
-    if (m_imageConvertorEstimate < 0)
+    auto const imageConvertorEstimate = imageConvertor->estimate();
+    if (imageConvertorEstimate < 0)
     {
         auto const message = "Failed to estimate image convertor";
         qCCritical(QLC_SERVICE) << message;
         throw std::runtime_error(message);
     }
 
-    m_tensorEngineEstimate = tensorEngine->estimate();
-    if (m_tensorEngineEstimate < 0)
+    auto const tensorEngineEstimate = tensorEngine->estimate();
+    if (tensorEngineEstimate < 0)
     {
         auto const message = "Failed to estimate tensor engine";
         qCCritical(QLC_SERVICE) << message;
         throw std::runtime_error(message);
     }
+
+    // startup estimate is only initial value, it is refined by real measurements
+    m_latencyEstimator->recordImage(imageConvertorEstimate);
+
+    auto const& batchCosts = tensorEngine->batchCosts();
+    for (size_t batches = 1; batches < batchCosts.size(); ++batches)
+    {
+        m_latencyEstimator->recordBatch(batches, batchCosts[batches]);
+    }
+    if (batchCosts.empty())
+    {
+        m_latencyEstimator->recordBatch(m_tensorEngineDispatcher->maxBatches(), tensorEngineEstimate);
+    }
 }
 
-qint64 Service::estimateNextRequest() const
+qint64 Service::estimateNextRequest(int priority) const
 {
-    int const countImageProcessing = (m_imageConvertorWorker->queueSize() + 1);
-    int const countTensorProcessing = countImageProcessing + m_tensorEngineWorker->queueSize();
-
-    int const batchesImageProcessing = countImageProcessing;
-    int const batchesTensorProcessing = countTensorProcessing / m_tensorEngineWorker->maxBatches() +
-            static_cast<bool>(countTensorProcessing % m_tensorEngineWorker->maxBatches());
+    // requests with lower priority will be handled after this request
+    return estimateRequest(m_imageConvertorWorker->queueSize(priority), m_tensorEngineDispatcher->queueSize(priority));
+}
 
-    auto const imageTimeProcessing = batchesImageProcessing * m_imageConvertorEstimate;
-    auto const tensorTimeProcessing = batchesTensorProcessing * m_tensorEngineEstimate;
+qint64 Service::estimateRequest(int imageQueueSize, int tensorQueueSize) const
+{
+    int const countImageProcessing = imageQueueSize + 1;
+    int const countTensorProcessing = countImageProcessing + tensorQueueSize;
+
+    // images are converted by all threads of pool in parallel
+    int const imageThreads = std::max<int>(m_imageConvertorWorker->maxThreads(), 1);
+    int const roundsImageProcessing = countImageProcessing / imageThreads +
+            static_cast<bool>(countImageProcessing % imageThreads);
+
+    // replicas forward batches in parallel, last round is partial batch
+    int const replicas = std::max<int>(m_tensorEngineDispatcher->replicas(), 1);
+    int const maxBatches = std::max<int>(m_tensorEngineDispatcher->maxBatches(), 1);
+    int const batchesCapacity = maxBatches * replicas;
+    int const fullRoundsTensorProcessing = countTensorProcessing / batchesCapacity;
+    int const lastRoundTensorProcessing = countTensorProcessing % batchesCapacity;
+
+    auto const imageTimeProcessing = roundsImageProcessing * m_latencyEstimator->imageCost();
+    auto tensorTimeProcessing = fullRoundsTensorProcessing * m_latencyEstimator->batchCost(maxBatches);
+    if (lastRoundTensorProcessing > 0)
+    {
+        auto const lastBatches = lastRoundTensorProcessing / replicas + static_cast<bool>(lastRoundTensorProcessing % replicas);
+        tensorTimeProcessing += m_latencyEstimator->batchCost(lastBatches);
+    }
 
     return (imageTimeProcessing + tensorTimeProcessing) / 1000000;
 }
 
+bool Service::admit(qint64 estimateMs, qint64 bytes, int count) const
+{
+    auto const queueSize = static_cast<int>(m_imageConvertorWorker->queueSize()) + m_tensorEngineDispatcher->queueSize();
+    if (m_settings.maxQueueSize() > 0 && queueSize + count > m_settings.maxQueueSize())
+    {
+        qCWarning(QLC_SERVICE) << "Queue size limit is reached:" << queueSize;
+        return false;
+    }
+
+    auto const queuedBytes = m_imageConvertorWorker->queuedBytes() + bytes;
+    if (m_settings.maxQueuedBytes() > 0 && queuedBytes > m_settings.maxQueuedBytes())
+    {
+        qCWarning(QLC_SERVICE) << "Queued bytes limit is reached:" << queuedBytes;
+        return false;
+    }
+
+    if (m_settings.maxEstimateMs() > 0 && estimateMs > m_settings.maxEstimateMs())
+    {
+        qCWarning(QLC_SERVICE) << "Estimate limit is reached:" << estimateMs;
+        return false;
+    }
+
+    return true;
+}
+
+template <typename T>
+QList<SkinCancerDetectorRequestInfo> Service::requestGroup(QList<T> const& images, Priority priority, qint64 deadlineMs)
+{
+    QList<SkinCancerDetectorRequestInfo> infos;
+    if (images.isEmpty())
+    {
+        return infos;
+    }
+
+    infos.reserve(images.size());
+
+    // queue sizes are read once, each next request of group is queued after previous
+    int const imageQueueSize = m_imageConvertorWorker->queueSize(priority);
+    int const tensorQueueSize = m_tensorEngineDispatcher->queueSize(priority);
+
+    QList<quint64> ids;
+    QList<RequestOptions> options;
+    ids.reserve(images.size());
+    options.reserve(images.size());
+    qint64 bytes = 0;
+
+    for (int i = 0; i < images.size(); ++i)
+    {
+        auto const id = getRequestId();
+        FlightRecorder::instance().record(FlightRecorder::Event::Received, id);
+        ids.append(id);
+        options.append(makeOptions(priority, deadlineMs));
+        infos.append(SkinCancerDetectorRequestInfo{id, estimateRequest(imageQueueSize + i, tensorQueueSize)});
+        bytes += requestBytes(images[i]);
+    }
+
+    qCInfo(QLC_SERVICE) << "Group request received:" << ids.first() << "-" << ids.last() << "data size" << bytes
+                        << "priority" << QMetaEnum::fromType<Priority>().key(priority)
+                        << "deadline ms" << deadlineMs << "estimates" << infos.last().estimateMs();
+
+    if (!admit(infos.last().estimateMs(), bytes, images.size()))
+    {
+        for (int i = 0; i < ids.size(); ++i)
+        {
+            infos[i] = reject(ids[i]);
+        }
+        return infos;
+    }
+
+    for (int i = 0; i < ids.size(); ++i)
+    {
+        m_cancelFlags.insert(ids[i], options[i].cancelFlag);
+    }
+    m_imageConvertorWorker->push(ids, images, options);
+
+    return infos;
+}
+
+SkinCancerDetectorRequestInfo Service::reject(quint64 id)
+{
+    Metrics::instance().countOutcome(Overloaded);
+
+    // failure is sent after reply, so client already knows id
+    QMetaObject::invokeMethod(this, [this, id] {
+        qCInfo(QLC_SERVICE) << "Request was rejected, id:" << id;
+        FlightRecorder::instance().record(FlightRecorder::Event::Emitted, id);
+        emit resultFailed(id, Overloaded);
+    }, Qt::QueuedConnection);
+
+    return SkinCancerDetectorRequestInfo{id, -1};
+}
+
+RequestOptions Service::makeOptions(Priority priority, qint64 deadlineMs)
+{
+    RequestOptions options;
+    options.priority = priority;
+    options.cancelFlag = std::make_shared<std::atomic_bool>(false);
+    options.received = RequestOptions::Clock::now();
+    if (deadlineMs > 0)
+    {
+        options.deadline = RequestOptions::Clock::now() + std::chrono::milliseconds(deadlineMs);
+    }
+
+    return options;
+}
+
 quint64 Service::getRequestId()
 {
     return ++m_requestId;
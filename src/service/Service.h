@@ -1,17 +1,21 @@
 #pragma once
 
 #include <rep_SkinCancerDetectorService_source.h>
+#include <QHash>
+#include <QTimer>
 #include <memory>
 
 #include "common/IEstimated.h"
 #include "engines/ITensorEngine.h"
 #include "image/IImageConvertor.h"
+#include "LatencyEstimator.h"
+#include "RequestOptions.h"
+#include "ServiceSettings.h"
 
 
 namespace service
 {
-class ServiceSettings;
-class TensorEngineWorker;
+class TensorEngineDispatcher;
 class ImageConvertorWorker;
 
 /**
@@ -35,6 +39,7 @@ protected:
      * @brief request from client
      * @param image - bin data of image
      * @return request info (id - request id, estimateMs - estimated time in ms for handle request, netgative - invalid value)
+     * request over admission limits is failed with Overloaded error and negative estimate
      */
     SkinCancerDetectorRequestInfo request(QByteArray image) override;
 
@@ -45,27 +50,109 @@ protected:
      */
     SkinCancerDetectorRequestInfo request(QString imagePath) override;
 
+    /**
+     * @brief request from client with scheduling options
+     * @param image - bin data of image
+     * @param priority - requests with higher priority are handled first
+     * @param deadlineMs - time in ms for handle request, requests with earlier deadline are handled first (0 - no deadline)
+     * @return request info (id - request id, estimateMs - estimated time in ms for handle request, netgative - invalid value)
+     */
+    SkinCancerDetectorRequestInfo request(QByteArray image, Priority priority, qint64 deadlineMs) override;
+
+    /**
+     * @brief request from client with scheduling options
+     * @param imagePath - path to local image
+     * @param priority - requests with higher priority are handled first
+     * @param deadlineMs - time in ms for handle request, requests with earlier deadline are handled first (0 - no deadline)
+     * @return request info (id - request id, estimateMs - estimated time in ms for handle request, netgative - invalid value)
+     */
+    SkinCancerDetectorRequestInfo request(QString imagePath, Priority priority, qint64 deadlineMs) override;
+
+    /**
+     * @brief group request from client, images are queued at once
+     * @param images - bin data of images
+     * @return request infos in order of images
+     */
+    QList<SkinCancerDetectorRequestInfo> request(QList<QByteArray> images) override;
+
+    /**
+     * @brief group request from client, images are queued at once
+     * @param imagePaths - paths to local images
+     * @return request infos in order of images
+     */
+    QList<SkinCancerDetectorRequestInfo> request(QList<QString> imagePaths) override;
+
+    /**
+     * @brief group request from client with scheduling options, images are queued at once
+     * @param images - bin data of images
+     * @param priority - priority of each request
+     * @param deadlineMs - deadline of each request (0 - no deadline)
+     * @return request infos in order of images
+     * group over admission limits is failed entirely with Overloaded error
+     */
+    QList<SkinCancerDetectorRequestInfo> request(QList<QByteArray> images, Priority priority, qint64 deadlineMs) override;
+
+    /**
+     * @brief group request from client with scheduling options, images are queued at once
+     * @param imagePaths - paths to local images
+     * @param priority - priority of each request
+     * @param deadlineMs - deadline of each request (0 - no deadline)
+     * @return request infos in order of images
+     */
+    QList<SkinCancerDetectorRequestInfo> request(QList<QString> imagePaths, Priority priority, qint64 deadlineMs) override;
+
+    /**
+     * @brief cancel request, its result or error will not be sent
+     * @param id - request id
+     * @return true if request was in progress
+     */
+    bool cancel(quint64 id) override;
+
+    /**
+     * @brief dump recent timestamps of requests in Chrome trace JSON format (chrome://tracing, Perfetto)
+     * @return path to dumped file on service host (empty if failed)
+     */
+    QString dumpTrace() override;
+
 private slots:
     void onSuccess(quint64 id, float positive, float negative);
     void onError(quint64 id, ErrorType type);
+    void flushResults();
 
 private:
     void createComponents();
     void setupService(ServiceSettings const& settings,
-                      engines::ITensorEnginePtr const& tensorEngine,
+                      engines::BaseTensorEngineSettings const& tensorSettings,
+                      QList<engines::ITensorEnginePtr> const& tensorEngines,
                       image::IImageConvertorPtr const& imageConvertor);
     void enableRemoting(ServiceSettings const& settings);
-    void estimate(common::IEstimated* imageConvertor, common::IEstimated* tensorEngine);
+    void estimate(common::IEstimated* imageConvertor, engines::ITensorEngine* tensorEngine);
+
+    template <typename T>
+    QList<SkinCancerDetectorRequestInfo> requestGroup(QList<T> const& images, Priority priority, qint64 deadlineMs);
 
-    qint64 estimateNextRequest() const;
+    qint64 estimateNextRequest(int priority = RequestOptions::DEFAULT_PRIORITY) const;
+    qint64 estimateRequest(int imageQueueSize, int tensorQueueSize) const;
+    bool admit(qint64 estimateMs, qint64 bytes, int count = 1) const;
+    SkinCancerDetectorRequestInfo reject(quint64 id);
     quint64 getRequestId();
 
+    static RequestOptions makeOptions(Priority priority, qint64 deadlineMs);
+
 private:
-    TensorEngineWorker* m_tensorEngineWorker = nullptr;
+    TensorEngineDispatcher* m_tensorEngineDispatcher = nullptr;
     ImageConvertorWorker* m_imageConvertorWorker = nullptr;
 
-    qint64 m_tensorEngineEstimate = -1;
-    qint64 m_imageConvertorEstimate = -1;
+    ServiceSettings m_settings{};
+
+    // requests in progress
+    QHash<quint64, RequestOptions::CancelFlag> m_cancelFlags{};
+
+    // coalesced results for resultsReady
+    QList<SkinCancerDetectorRequestResult> m_results{};
+    QTimer m_resultsFlushTimer{};
+
+    LatencyEstimatorPtr m_latencyEstimator = nullptr;
     quint64 m_requestId = 0;
 };
 }
@@ -19,8 +19,47 @@ int ServiceSettings::maxImageConvertorThreads() const
     return m_maxImageConvertorThreads;
 }
 
+QString const& ServiceSettings::imageConvertorCpus() const
+{
+    return m_imageConvertorCpus;
+}
+
+int ServiceSettings::maxQueueSize() const
+{
+    return m_maxQueueSize;
+}
+
+qint64 ServiceSettings::maxQueuedBytes() const
+{
+    return m_maxQueuedBytes;
+}
+
+int ServiceSettings::maxEstimateMs() const
+{
+    return m_maxEstimateMs;
+}
+
+int ServiceSettings::resultsFlushMs() const
+{
+    return m_resultsFlushMs;
+}
+
+int ServiceSettings::metricsPort() const
+{
+    return m_metricsPort;
+}
+
 bool ServiceSettings::parse(QJsonObject const& json)
 {
+    double maxQueuedBytes = 0;
+    JSON_HELPER.get(json, "imageConvertorCpus", m_imageConvertorCpus, false);
+    JSON_HELPER.get(json, "maxQueueSize", m_maxQueueSize, false);
+    JSON_HELPER.get(json, "maxQueuedBytes", maxQueuedBytes, false);
+    JSON_HELPER.get(json, "maxEstimateMs", m_maxEstimateMs, false);
+    JSON_HELPER.get(json, "resultsFlushMs", m_resultsFlushMs, false);
+    JSON_HELPER.get(json, "metricsPort", m_metricsPort, false);
+    m_maxQueuedBytes = static_cast<qint64>(maxQueuedBytes);
+
     QString url;
     return JSON_HELPER.get(json, "url", url, true)
             && JSON_HELPER.get(json, "maxImageConvertorThreads", m_maxImageConvertorThreads, true)
@@ -29,6 +68,11 @@ bool ServiceSettings::parse(QJsonObject const& json)
 
 bool ServiceSettings::valid() const
 {
-    return url().isValid() && !url().isEmpty();
+    return url().isValid() && !url().isEmpty()
+            && maxQueueSize() >= 0
+            && maxQueuedBytes() >= 0
+            && maxEstimateMs() >= 0
+            && resultsFlushMs() >= 0
+            && metricsPort() >= 0 && metricsPort() <= 65535;
 }
 }
@@ -28,6 +28,48 @@ public:
      */
     int maxImageConvertorThreads() const;
 
+    /**
+     * @brief cpus for pinning image convertor threads (empty - not pinned)
+     * list of cpus and ranges ("0-7,16") or NUMA node ("node:0")
+     * @return cpus
+     */
+    QString const& imageConvertorCpus() const;
+
+    /**
+     * @brief max count of requests in all queues for admission new request
+     * if zero is unlimited
+     * @return
+     */
+    int maxQueueSize() const;
+
+    /**
+     * @brief max bytes of queued image data for admission new request
+     * if zero is unlimited
+     * @return
+     */
+    qint64 maxQueuedBytes() const;
+
+    /**
+     * @brief max estimated time in ms of new request for admission
+     * if zero is unlimited
+     * @return
+     */
+    int maxEstimateMs() const;
+
+    /**
+     * @brief flush window in ms for coalescing results into one resultsReady signal
+     * if zero results handled in one event loop iteration are coalesced (usually one engine batch)
+     * @return
+     */
+    int resultsFlushMs() const;
+
+    /**
+     * @brief port of HTTP endpoint on localhost with Prometheus metrics
+     * if zero endpoint is disabled
+     * @return
+     */
+    int metricsPort() const;
+
 public: // IJsonParsed interface
     bool parse(const QJsonObject &json) override;
 
@@ -37,5 +79,11 @@ public: // ISettings interface
 private:
     QUrl m_url{};
     int m_maxImageConvertorThreads = 0;
+    QString m_imageConvertorCpus{};
+    int m_maxQueueSize = 0;
+    qint64 m_maxQueuedBytes = 0;
+    int m_maxEstimateMs = 0;
+    int m_resultsFlushMs = 0;
+    int m_metricsPort = 0;
 };
 }
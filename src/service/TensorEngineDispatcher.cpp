@@ -0,0 +1,167 @@
+#include "TensorEngineDispatcher.h"
+#include "TensorEngineWorker.h"
+#include "utils/ThreadAffinity.h"
+
+#include <QLoggingCategory>
+
+#include <thread>
+#include <algorithm>
+
+
+namespace service
+{
+Q_LOGGING_CATEGORY(QLC_TENSOR_DISPATCHER, "TensorEngineDispatcher")
+
+TensorEngineDispatcher::TensorEngineDispatcher(QList<engines::ITensorEnginePtr> const& engines,
+                                               engines::BaseTensorEngineSettings const& settings,
+                                               QObject* parent)
+    : QObject(parent)
+{
+    auto const defaultMaxThreads = settings.threadsPerReplica() > 0 || engines.size() < 2
+            ? settings.threadsPerReplica()
+            : std::max<size_t>(std::thread::hardware_concurrency() / engines.size(), 1);
+
+    qCInfo(QLC_TENSOR_DISPATCHER) << "Replicas:" << engines.size() << "threads per replica:" << defaultMaxThreads;
+
+    auto const& replicasCpus = settings.replicasCpus();
+    for (int i = 0; i < engines.size(); ++i)
+    {
+        auto const cpus = replicasCpus.isEmpty()
+                ? std::vector<int>{}
+                : utils::ThreadAffinity::parse(replicasCpus[i % replicasCpus.size()]);
+
+        // pinned replica uses all own cpus by default
+        auto const maxThreads = settings.threadsPerReplica() == 0 && !cpus.empty() ? cpus.size() : defaultMaxThreads;
+        if (!cpus.empty())
+        {
+            qCInfo(QLC_TENSOR_DISPATCHER) << "Replica" << i << "pinned to cpus:" << replicasCpus[i % replicasCpus.size()]
+                                          << "threads:" << maxThreads;
+        }
+
+        auto const worker = new TensorEngineWorker(engines[i], settings, maxThreads, cpus, this);
+
+        connect(worker, &TensorEngineWorker::result, this, &TensorEngineDispatcher::result, Qt::DirectConnection);
+        connect(worker, &TensorEngineWorker::error, this, &TensorEngineDispatcher::error, Qt::DirectConnection);
+
+        m_workers.append(worker);
+    }
+
+    for (auto const worker : m_workers)
+    {
+        worker->setSiblings(m_workers);
+    }
+}
+
+TensorEngineDispatcher::~TensorEngineDispatcher()
+{
+    if (running())
+    {
+        stop();
+    }
+}
+
+bool TensorEngineDispatcher::running() const
+{
+    return !m_workers.isEmpty() && std::all_of(m_workers.begin(), m_workers.end(), [] (auto const worker) {
+        return worker->running();
+    });
+}
+
+int TensorEngineDispatcher::queueSize() const
+{
+    int size = 0;
+    for (auto const worker : m_workers)
+    {
+        size += worker->queueSize();
+    }
+
+    return size;
+}
+
+int TensorEngineDispatcher::queueSize(int priority) const
+{
+    int size = 0;
+    for (auto const worker : m_workers)
+    {
+        size += worker->queueSize(priority);
+    }
+
+    return size;
+}
+
+size_t TensorEngineDispatcher::maxBatches() const
+{
+    return m_workers.isEmpty() ? 0 : m_workers.first()->maxBatches();
+}
+
+size_t TensorEngineDispatcher::replicas() const
+{
+    return m_workers.size();
+}
+
+double TensorEngineDispatcher::batchFillRatio() const
+{
+    if (m_workers.isEmpty())
+    {
+        return 0;
+    }
+
+    double ratio = 0;
+    for (auto const worker : m_workers)
+    {
+        ratio += worker->batchFillRatio();
+    }
+
+    return ratio / m_workers.size();
+}
+
+void TensorEngineDispatcher::setLatencyEstimator(LatencyEstimatorPtr const& latencyEstimator)
+{
+    for (auto const worker : m_workers)
+    {
+        worker->setLatencyEstimator(latencyEstimator);
+    }
+}
+
+void TensorEngineDispatcher::prepareEngines()
+{
+    for (auto const worker : m_workers)
+    {
+        worker->prepareEngine();
+    }
+}
+
+void TensorEngineDispatcher::start()
+{
+    for (auto const worker : m_workers)
+    {
+        worker->start();
+    }
+}
+
+void TensorEngineDispatcher::stop()
+{
+    for (auto const worker : m_workers)
+    {
+        worker->stop();
+    }
+}
+
+void TensorEngineDispatcher::push(quint64 id, common::IEngineInputDataPtr const& data, RequestOptions const& options)
+{
+    // start from next worker by round robin, so equal loaded workers share requests
+    auto const first = m_nextWorker++ % m_workers.size();
+    auto target = m_workers[static_cast<int>(first)];
+
+    for (int i = 1; i < m_workers.size() && target->queueSize() > 0; ++i)
+    {
+        auto const worker = m_workers[static_cast<int>((first + i) % m_workers.size())];
+        if (worker->queueSize() < target->queueSize())
+        {
+            target = worker;
+        }
+    }
+
+    target->push(id, data, options);
+}
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <QObject>
+#include <QList>
+
+#include <atomic>
+
+#include <rep_SkinCancerDetectorService_source.h>
+
+#include "common/IEngineInputData.h"
+#include "engines/ITensorEngine.h"
+#include "LatencyEstimator.h"
+#include "RequestOptions.h"
+
+
+namespace service
+{
+class TensorEngineWorker;
+
+/**
+ * @brief The TensorEngineDispatcher class - dispatch requests to tensor engine replicas,
+ * each replica is forwarded by own TensorEngineWorker, idle workers steal requests from others
+ */
+class TensorEngineDispatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TensorEngineDispatcher(QList<engines::ITensorEnginePtr> const& engines,
+                                    engines::BaseTensorEngineSettings const& settings,
+                                    QObject* parent = nullptr);
+    ~TensorEngineDispatcher();
+
+    /**
+     * @brief running - all workers are running
+     * @return state
+     */
+    bool running() const;
+
+    /**
+     * @brief queue size of all workers
+     * @return size
+     */
+    int queueSize() const;
+
+    /**
+     * @brief count of queued requests of all workers
+     * which will be forwarded not later than request with priority
+     * @param priority
+     * @return size
+     */
+    int queueSize(int priority) const;
+
+    /**
+     * @brief max batches of one replica
+     * @return
+     */
+    size_t maxBatches() const;
+
+    /**
+     * @brief count of replicas
+     * @return
+     */
+    size_t replicas() const;
+
+    /**
+     * @brief achieved batch fill ratio of all workers
+     * @return ratio in range [0, 1]
+     */
+    double batchFillRatio() const;
+
+    /**
+     * @brief set estimator for recording cost of forwarded batches of all workers
+     * @warning should be called before start
+     * @param latencyEstimator
+     */
+    void setLatencyEstimator(LatencyEstimatorPtr const& latencyEstimator);
+
+    /**
+     * @brief prepare infer threads of all replicas with their threads budget and cpus
+     * @warning should be called before start
+     */
+    void prepareEngines();
+
+public slots:
+    /**
+     * @brief start all workers
+     */
+    void start();
+
+    /**
+     * @brief stop all workers
+     */
+    void stop();
+
+    /**
+     * @brief push request to least loaded worker
+     * @param id - request id
+     * @param data
+     * @param options - scheduling options
+     */
+    void push(quint64 id, common::IEngineInputDataPtr const& data, RequestOptions const& options = {});
+
+signals:
+    /**
+     * @brief result ready signal
+     * @param id - request id
+     */
+    void result(quint64 id, float positive, float negative);
+
+    /**
+     * @brief error signal
+     * @param id - request id
+     */
+    void error(quint64 id, SkinCancerDetectorServiceSource::ErrorType type);
+
+private:
+    QList<TensorEngineWorker*> m_workers{};
+    std::atomic_size_t m_nextWorker = 0;
+};
+}
@@ -1,7 +1,13 @@
 #include "TensorEngineWorker.h"
+#include "FlightRecorder.h"
+#include "Metrics.h"
+#include "utils/ThreadAffinity.h"
 
 #include <QLoggingCategory>
 
+#include <algorithm>
+#include <limits>
+
 
 namespace service
 {
@@ -9,10 +15,21 @@ Q_LOGGING_CATEGORY(QLC_TENSOR_WORKER, "TensorEngineWorker")
 
 using Tensor = engines::ITensorEngine::Tensor;
 
-TensorEngineWorker::TensorEngineWorker(engines::ITensorEnginePtr const& engine, QObject* parent)
+TensorEngineWorker::TensorEngineWorker(engines::ITensorEnginePtr const& engine,
+                                       engines::BaseTensorEngineSettings const& settings,
+                                       size_t maxThreads,
+                                       std::vector<int> const& cpus,
+                                       QObject* parent)
     : QObject(parent)
     , m_engine(engine)
+    , m_maxThreads(maxThreads)
+    , m_cpus(cpus)
+    , m_batchingPolicy(settings, engine->maxBatches())
+    , m_queue(settings.queueCapacity())
 {
+    qCInfo(QLC_TENSOR_WORKER) << "Batching policy, target batches:" << m_batchingPolicy.targetBatches()
+                              << "max wait us:" << settings.maxBatchWaitUs()
+                              << "latency budget us:" << settings.latencyBudgetUs();
 }
 
 TensorEngineWorker::~TensorEngineWorker()
@@ -30,7 +47,12 @@ bool TensorEngineWorker::running() const
 
 int TensorEngineWorker::queueSize() const
 {
-    return m_requests.size();
+    return m_queueSize.size();
+}
+
+int TensorEngineWorker::queueSize(int priority) const
+{
+    return m_queueSize.size(priority);
 }
 
 size_t TensorEngineWorker::maxBatches() const
@@ -38,6 +60,47 @@ size_t TensorEngineWorker::maxBatches() const
     return m_engine->maxBatches();
 }
 
+double TensorEngineWorker::batchFillRatio() const
+{
+    return m_batchingPolicy.fillRatio();
+}
+
+void TensorEngineWorker::setSiblings(QList<TensorEngineWorker*> const& siblings)
+{
+    if (running())
+    {
+        qCWarning(QLC_TENSOR_WORKER) << "Cannot set siblings in running state";
+        return;
+    }
+
+    m_siblings = siblings;
+    m_siblings.removeAll(this);
+}
+
+void TensorEngineWorker::setLatencyEstimator(LatencyEstimatorPtr const& latencyEstimator)
+{
+    if (running())
+    {
+        qCWarning(QLC_TENSOR_WORKER) << "Cannot set latency estimator in running state";
+        return;
+    }
+
+    m_latencyEstimator = latencyEstimator;
+    m_batchingPolicy.setLatencyEstimator(latencyEstimator);
+}
+
+void TensorEngineWorker::prepareEngine()
+{
+    if (running())
+    {
+        qCWarning(QLC_TENSOR_WORKER) << "Cannot prepare engine in running state";
+        return;
+    }
+
+    m_engine->prepareThread(m_maxThreads, m_cpus);
+    m_enginePrepared = true;
+}
+
 void TensorEngineWorker::start()
 {
     if (running())
@@ -72,27 +135,95 @@ void TensorEngineWorker::stop()
 
     qCInfo(QLC_TENSOR_WORKER) << "Stop requiered";
 
-    m_stop = true;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
     m_notifier.notify_one();
+    notifySpace();
     if (m_thread.joinable())
     {
         m_thread.join();
     }
+
+    // requests pushed concurrently with stop
+    drainQueue();
+    while (pendingSize() > 0)
+    {
+        QList<Request> pending;
+        {
+            std::unique_lock<std::mutex> lock(m_pendingMutex);
+            pending.swap(m_pending);
+        }
+
+        for (auto const& request : pending)
+        {
+            m_queueSize.decrement(request.options.priority);
+            emit error(request.id, SkinCancerDetectorServiceSource::StopService);
+        }
+        drainQueue();
+    }
+
+    qCInfo(QLC_TENSOR_WORKER) << "Achieved batch fill ratio:" << batchFillRatio();
 }
 
-void TensorEngineWorker::push(quint64 id, common::IEngineInputDataPtr const& data)
+void TensorEngineWorker::push(quint64 id, common::IEngineInputDataPtr const& data, RequestOptions const& options)
 {
     if (m_stop)
     {
         qCWarning(QLC_TENSOR_WORKER) << "Reject request by stop" << id;
         error(id, SkinCancerDetectorServiceSource::StopService);
+        return;
     }
-    else
+
+    FlightRecorder::instance().record(FlightRecorder::Event::EngineEnqueue, id);
+
+    // count before publish, so queue size is never less than real
+    auto const size = m_queueSize.increment(options.priority);
+
+    Request request{id, data, Clock::now(), options};
+    if (!m_queue.tryPush(std::move(request)))
+    {
+        // queue is full, engine is bottleneck - back pressure to producer, but bounded
+        bool queued = false;
+        {
+            std::unique_lock<std::mutex> lock(m_spaceMutex);
+            m_spaceNotifier.wait_for(lock, FULL_QUEUE_WAIT, [this, &request, &queued] {
+                queued = m_queue.tryPush(std::move(request));
+                return queued || m_stop;
+            });
+        }
+
+        if (!queued)
+        {
+            qCWarning(QLC_TENSOR_WORKER) << "Reject request by full queue" << id;
+            m_queueSize.decrement(options.priority);
+            emit error(id, m_stop ? SkinCancerDetectorServiceSource::StopService
+                                  : SkinCancerDetectorServiceSource::Overloaded);
+            return;
+        }
+    }
+
+    auto const threshold = m_wakeThreshold.load();
+
+    // wake up worker only when it sleeps and enough requests are queued
+    if (threshold > 0 && size >= threshold)
     {
         std::unique_lock<std::mutex> lock(m_mutex);
-        m_requests.append({id, data});
         m_notifier.notify_one();
     }
+
+    // backlog above next batch is served by idle sibling, it sleeps on own queue only
+    if (static_cast<size_t>(size) > m_engine->maxBatches())
+    {
+        for (auto const sibling : m_siblings)
+        {
+            if (sibling->wakeToSteal())
+            {
+                break;
+            }
+        }
+    }
 }
 
 void TensorEngineWorker::setRunning(bool running)
@@ -110,52 +241,360 @@ void TensorEngineWorker::setRunning(bool running)
 
 void TensorEngineWorker::run()
 {
+    // requests are staged by worker thread, so it is pinned as engine threads
+    utils::ThreadAffinity::pinCurrentThread(m_cpus);
+    if (!m_enginePrepared)
+    {
+        m_engine->prepareThread(m_maxThreads, m_cpus);
+        m_enginePrepared = true;
+    }
     setRunning(true);
 
-    while (!(m_stop && m_requests.empty()))
+    // forward end wakes worker which accumulates next batch meanwhile
+    m_engine->setInferDoneCallback([this] {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_inferDone = true;
+        }
+        m_notifier.notify_one();
+    });
+
+    QList<Request> inferring;
+
+    while (true)
     {
-        QList<Request> processedData;
+        // while engine forwards previous batch, next batch is staged to free input buffer
+        auto processedData = takeBatch(!inferring.isEmpty());
+        bool const drained = processedData.isEmpty();
+        if (!drained && !loadData(processedData))
+        {
+            sendFailed(processedData);
+            processedData.clear();
+        }
+
+        if (!inferring.isEmpty())
+        {
+            completeBatch(inferring);
+            inferring.clear();
+        }
+        else if (drained)
+        {
+            break;
+        }
+
+        if (processedData.isEmpty())
+        {
+            continue;
+        }
+
+        for (auto const& request : processedData)
+        {
+            FlightRecorder::instance().record(FlightRecorder::Event::InferStart, request.id);
+        }
+
         {
             std::unique_lock<std::mutex> lock(m_mutex);
-            while (m_requests.empty())
-            {
-                m_notifier.wait(lock);
-            }
+            m_inferDone = false;
+        }
+        if (!m_engine->inferAsync(processedData.size()))
+        {
+            sendFailed(processedData);
+            continue;
+        }
 
-            if (m_requests.empty())
-            {
-                continue;
-            }
+        inferring = std::move(processedData);
+    }
+
+    m_engine->setInferDoneCallback({});
+    setRunning(false);
+}
+
+void TensorEngineWorker::completeBatch(QList<Request> const& data)
+{
+    QVector<Tensor> output(data.size() * m_engine->outputSize());
+    if (!(m_engine->waitInfer()
+          && m_engine->unloadOutput(data.size(), output.data())))
+    {
+        sendFailed(data);
+        return;
+    }
+
+    // forward is measured by engine, so staging of next batch is not counted
+    auto const inferNs = m_engine->lastInferNs();
+    auto const inferEnd = m_engine->lastInferEnd();
+    for (auto const& request : data)
+    {
+        FlightRecorder::instance().record(FlightRecorder::Event::InferEnd, request.id, inferEnd);
+    }
 
-            if (static_cast<size_t>(m_requests.size()) > m_engine->maxBatches())
+    m_batchingPolicy.record(data.size());
+    if (m_latencyEstimator)
+    {
+        m_latencyEstimator->recordBatch(data.size(), inferNs);
+    }
+
+    auto& metrics = Metrics::instance();
+    metrics.observe(Metrics::Stage::Infer, inferNs);
+    metrics.observeBatch(data.size(), inferNs);
+
+    auto const now = Clock::now();
+    for (auto const& request : data)
+    {
+        if (request.options.received != Clock::time_point{})
+        {
+            metrics.observe(Metrics::Stage::Total, std::chrono::duration_cast<std::chrono::nanoseconds>(now - request.options.received).count());
+        }
+    }
+    qCDebug(QLC_TENSOR_WORKER) << "Batch forwarded:" << data.size()
+                               << "fill ratio:" << batchFillRatio();
+
+    for (int b = 0; b < data.size(); ++b)
+    {
+        auto const pos = output[b * m_engine->outputSize() + m_engine->positiveIndex()];
+        auto const neg = output[b * m_engine->outputSize() + m_engine->negativeIndex()];
+        emit result(data[b].id, pos, neg);
+    }
+}
+
+QList<TensorEngineWorker::Request> TensorEngineWorker::takeBatch(bool inferring)
+{
+    drainQueue();
+    stealRequests();
+
+    if (inferring)
+    {
+        // engine is busy - accumulate requests until forward is finished, but never block longer
+        if (static_cast<size_t>(pendingSize()) < m_batchingPolicy.targetBatches() && !m_stop)
+        {
+            waitQueue(static_cast<int>(m_batchingPolicy.targetBatches()), nullptr, true);
+            drainQueue();
+            stealRequests();
+        }
+    }
+    else
+    {
+        // cancelled requests can empty held batch, then wait again
+        do
+        {
+            while (pendingSize() == 0 && !m_stop)
             {
-                processedData = m_requests.mid(0, m_engine->maxBatches());
-                m_requests.erase(m_requests.begin(), m_requests.begin() + m_engine->maxBatches());
+                m_idle = true;
+                waitQueue(1);
+                m_idle = false;
+                drainQueue();
+                stealRequests();
             }
-            else
+
+            // hold partial batch while it is profitable, stop flushes immediately
+            while (pendingSize() > 0 && !m_stop)
             {
-                processedData = std::move(m_requests);
+                auto const now = Clock::now();
+                auto oldest = Clock::time_point::max();
+                auto earliestDeadline = Clock::time_point::max();
+                int pending = 0;
+                {
+                    std::unique_lock<std::mutex> lock(m_pendingMutex);
+                    for (auto const& request : m_pending)
+                    {
+                        oldest = std::min(oldest, request.pushed);
+                        earliestDeadline = std::min(earliestDeadline, request.options.deadline);
+                    }
+                    pending = m_pending.size();
+                }
+
+                // pending is stolen by sibling meanwhile
+                if (pending == 0)
+                {
+                    break;
+                }
+
+                auto const oldestAge = std::chrono::duration_cast<std::chrono::nanoseconds>(now - oldest).count();
+                auto const deadlineSlack = earliestDeadline == Clock::time_point::max()
+                        ? std::numeric_limits<qint64>::max()
+                        : std::chrono::duration_cast<std::chrono::nanoseconds>(earliestDeadline - now).count();
+                auto const hold = m_batchingPolicy.holdNs(static_cast<size_t>(pending), oldestAge, deadlineSlack);
+
+                if (hold <= 0)
+                {
+                    break;
+                }
+
+                auto const deadline = now + std::chrono::nanoseconds(hold);
+                waitQueue(static_cast<int>(m_batchingPolicy.targetBatches()), &deadline);
+                drainQueue();
+                stealRequests();
             }
         }
+        while (pendingSize() == 0 && !m_stop);
+    }
+
+    // pending is ordered, so batch takes most urgent requests
+    QList<Request> processedData;
+    {
+        std::unique_lock<std::mutex> lock(m_pendingMutex);
+        auto const count = std::min<int>(m_pending.size(), static_cast<int>(m_engine->maxBatches()));
+        processedData = m_pending.mid(0, count);
+        m_pending.erase(m_pending.begin(), m_pending.begin() + count);
+    }
+
+    auto const now = Clock::now();
+    for (auto const& request : processedData)
+    {
+        m_queueSize.decrement(request.options.priority);
+        Metrics::instance().observe(Metrics::Stage::EngineQueue, std::chrono::duration_cast<std::chrono::nanoseconds>(now - request.pushed).count());
+        FlightRecorder::instance().record(FlightRecorder::Event::BatchFormed, request.id);
+    }
+
+    return processedData;
+}
 
-        QVector<Tensor> output(processedData.size() * m_engine->outputSize());
-        if (!(loadData(processedData)
-              && m_engine->infer(processedData.size())
-              && m_engine->unloadOutput(processedData.size(), output.data())))
+void TensorEngineWorker::drainQueue()
+{
+    std::unique_lock<std::mutex> lock(m_pendingMutex);
+
+    Request request;
+    bool popped = false;
+    while (m_queue.tryPop(request))
+    {
+        addPending(std::move(request));
+        popped = true;
+    }
+
+    dropCancelled();
+
+    if (popped)
+    {
+        notifySpace();
+    }
+}
+
+void TensorEngineWorker::notifySpace()
+{
+    std::unique_lock<std::mutex> lock(m_spaceMutex);
+    m_spaceNotifier.notify_all();
+}
+
+void TensorEngineWorker::dropCancelled()
+{
+    auto const cancelled = std::remove_if(m_pending.begin(), m_pending.end(), [this] (Request const& request) {
+        if (!request.options.cancelled())
         {
-            sendFailed(processedData);
-            continue;
+            return false;
+        }
+
+        qCDebug(QLC_TENSOR_WORKER) << "Drop cancelled request" << request.id;
+        m_queueSize.decrement(request.options.priority);
+        return true;
+    });
+
+    m_pending.erase(cancelled, m_pending.end());
+}
+
+void TensorEngineWorker::addPending(Request&& request)
+{
+    auto const position = std::upper_bound(m_pending.begin(), m_pending.end(), request,
+                                           [] (Request const& left, Request const& right) {
+        return left.options.before(right.options);
+    });
+
+    m_pending.insert(position, std::move(request));
+}
+
+int TensorEngineWorker::pendingSize()
+{
+    std::unique_lock<std::mutex> lock(m_pendingMutex);
+    return m_pending.size();
+}
+
+void TensorEngineWorker::stealRequests()
+{
+    auto const maxBatches = static_cast<int>(m_engine->maxBatches());
+    auto const pending = pendingSize();
+    if (pending >= maxBatches)
+    {
+        return;
+    }
+
+    // own pending is not locked while sibling is locked, so workers stealing from each other don't deadlock
+    QList<Request> stolen;
+    Request request;
+    for (auto const sibling : m_siblings)
+    {
+        while (pending + stolen.size() < maxBatches && sibling->steal(request))
+        {
+            m_queueSize.increment(request.options.priority);
+            stolen.append(std::move(request));
         }
+    }
+
+    std::unique_lock<std::mutex> lock(m_pendingMutex);
+    for (auto& stolenRequest : stolen)
+    {
+        addPending(std::move(stolenRequest));
+    }
+}
 
-        for (int b = 0; b < processedData.size(); ++b)
+bool TensorEngineWorker::steal(Request& request)
+{
+    if (m_queue.tryPop(request))
+    {
+        notifySpace();
+    }
+    else
+    {
+        // owner keeps its next batch, the least urgent rest of pending can be stolen
+        std::unique_lock<std::mutex> lock(m_pendingMutex);
+        if (static_cast<size_t>(m_pending.size()) <= m_engine->maxBatches())
         {
-            auto const pos = output[b * m_engine->outputSize() + m_engine->positiveIndex()];
-            auto const neg = output[b * m_engine->outputSize() + m_engine->negativeIndex()];
-            emit result(processedData[b].id, pos, neg);
+            return false;
         }
+
+        request = m_pending.takeLast();
     }
 
-    setRunning(false);
+    m_queueSize.decrement(request.options.priority);
+    qCDebug(QLC_TENSOR_WORKER) << "Request stolen:" << request.id;
+
+    return true;
+}
+
+bool TensorEngineWorker::wakeToSteal()
+{
+    // worker holding or staging batch steals by itself after wake
+    if (!m_idle)
+    {
+        return false;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_stealRequired = true;
+    }
+    m_notifier.notify_one();
+
+    return true;
+}
+
+void TensorEngineWorker::waitQueue(int count, Clock::time_point const* deadline, bool untilInferDone)
+{
+    auto const ready = [this, count, untilInferDone] {
+        return m_stop || m_stealRequired || m_queueSize.size() >= count || (untilInferDone && m_inferDone);
+    };
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_wakeThreshold = count;
+
+    if (deadline)
+    {
+        m_notifier.wait_until(lock, *deadline, ready);
+    }
+    else
+    {
+        m_notifier.wait(lock, ready);
+    }
+
+    m_wakeThreshold = 0;
+    m_stealRequired = false;
 }
 
 void TensorEngineWorker::sendFailed(QList<TensorEngineWorker::Request> const& data)
@@ -4,14 +4,21 @@
 #include <QList>
 
 #include <memory>
+#include <atomic>
+#include <chrono>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
+#include <vector>
 
 #include <rep_SkinCancerDetectorService_source.h>
 
 #include "common/IEngineInputData.h"
 #include "engines/ITensorEngine.h"
+#include "utils/MpmcRingBuffer.h"
+#include "BatchingPolicy.h"
+#include "LatencyEstimator.h"
+#include "RequestOptions.h"
 
 
 namespace service
@@ -26,7 +33,11 @@ class TensorEngineWorker : public QObject
     Q_PROPERTY(bool running READ running NOTIFY runningChanged)
 
 public:
-    explicit TensorEngineWorker(engines::ITensorEnginePtr const& engine, QObject* parent = nullptr);
+    explicit TensorEngineWorker(engines::ITensorEnginePtr const& engine,
+                                engines::BaseTensorEngineSettings const& settings,
+                                size_t maxThreads,
+                                std::vector<int> const& cpus,
+                                QObject* parent = nullptr);
     ~TensorEngineWorker();
 
     /**
@@ -41,12 +52,47 @@ public:
      */
     int queueSize() const;
 
+    /**
+     * @brief count of queued requests which will be forwarded not later than request with priority
+     * @param priority
+     * @return size
+     */
+    int queueSize(int priority) const;
+
     /**
      * @brief max batches
      * @return
      */
     size_t maxBatches() const;
 
+    /**
+     * @brief achieved batch fill ratio
+     * @return ratio in range [0, 1]
+     */
+    double batchFillRatio() const;
+
+    /**
+     * @brief set workers for stealing requests when own queue is empty
+     * @warning should be called before start
+     * @param siblings - other workers (this worker is ignored)
+     */
+    void setSiblings(QList<TensorEngineWorker*> const& siblings);
+
+    /**
+     * @brief set estimator for recording cost of each forwarded batch,
+     * batching policy holds partial batch by its costs
+     * @warning should be called before start
+     * @param latencyEstimator - shared by all workers
+     */
+    void setLatencyEstimator(LatencyEstimatorPtr const& latencyEstimator);
+
+    /**
+     * @brief prepare infer thread of engine with threads budget and cpus of replica,
+     * so engine can be estimated as it runs in worker, otherwise engine is prepared on start
+     * @warning should be called before start
+     */
+    void prepareEngine();
+
 public slots:
     /**
      * @brief start worker
@@ -59,11 +105,14 @@ public slots:
     void stop();
 
     /**
-     * @brief push request to worker
+     * @brief push request to worker, thread safe and lock free
+     * while queue is not full, otherwise waits for space limited time
+     * and fails request with Overloaded error
      * @param id - request id
      * @param data
+     * @param options - scheduling options
      */
-    void push(quint64 id, common::IEngineInputDataPtr const& data);
+    void push(quint64 id, common::IEngineInputDataPtr const& data, RequestOptions const& options = {});
 
 signals:
     /**
@@ -85,28 +134,68 @@ signals:
     void error(quint64 id, SkinCancerDetectorServiceSource::ErrorType type);
 
 private:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr auto FULL_QUEUE_WAIT = std::chrono::milliseconds(100);
+
     struct Request
     {
-        quint64 id;
-        common::IEngineInputDataPtr data;
+        quint64 id = 0;
+        common::IEngineInputDataPtr data = nullptr;
+        Clock::time_point pushed{};
+        RequestOptions options{};
     };
 
 private:
     void setRunning(bool running);
 
     void run();
+    QList<Request> takeBatch(bool inferring = false);
+    void completeBatch(QList<Request> const& data);
+    void drainQueue();
+    void notifySpace();
+    void addPending(Request&& request);
+    void dropCancelled();
+    int pendingSize();
+    void stealRequests();
+    bool steal(Request& request);
+    bool wakeToSteal();
+    void waitQueue(int count, Clock::time_point const* deadline = nullptr, bool untilInferDone = false);
     void sendFailed(QList<Request> const& data);
     bool loadData(QList<Request> const& data);
 
 private:
     engines::ITensorEnginePtr m_engine = nullptr;
+    size_t m_maxThreads = 0;
+    std::vector<int> m_cpus{};
+    bool m_enginePrepared = false;
+    QList<TensorEngineWorker*> m_siblings{};
+    BatchingPolicy m_batchingPolicy;
+    LatencyEstimatorPtr m_latencyEstimator = nullptr;
 
     std::thread m_thread{};
     std::mutex m_mutex{};
     std::condition_variable m_notifier{};
     bool m_running = false;
-    bool m_stop = false;
-
-    QList<Request> m_requests{};
+    std::atomic_bool m_stop = false;
+    // forward started by inferAsync is finished, guarded by mutex
+    bool m_inferDone = false;
+    // sibling has backlog to steal, guarded by mutex
+    bool m_stealRequired = false;
+
+    utils::MpmcRingBuffer<Request> m_queue;
+    // producers wait for space in full queue
+    std::mutex m_spaceMutex{};
+    std::condition_variable m_spaceNotifier{};
+    QueueCounter m_queueSize{};
+    std::atomic_int m_wakeThreshold = 0;
+    // worker sleeps without pending requests
+    std::atomic_bool m_idle = false;
+
+    // requests taken from queue by worker thread, but not forwarded yet
+    // ordered by priority, then by earliest deadline, guarded by pending mutex
+    // because siblings steal its tail
+    std::mutex m_pendingMutex{};
+    QList<Request> m_pending{};
 };
 }
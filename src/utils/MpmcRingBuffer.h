@@ -0,0 +1,147 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+
+namespace utils
+{
+/**
+ * @brief The MpmcRingBuffer class - bounded lock-free queue
+ * for many producers and many consumers
+ * each slot has own sequence number, so producers and consumers reserve slots by one CAS
+ * and never touch shared position of opposite side
+ */
+template <typename T>
+class MpmcRingBuffer
+{
+public:
+    /**
+     * @param capacity - will be rounded up to power of two
+     */
+    explicit MpmcRingBuffer(size_t capacity)
+    {
+        size_t size = 2;
+        while (size < capacity)
+        {
+            size <<= 1;
+        }
+
+        m_mask = size - 1;
+        m_slots = std::make_unique<Slot[]>(size);
+        for (size_t i = 0; i < size; ++i)
+        {
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpmcRingBuffer(MpmcRingBuffer const&) = delete;
+    MpmcRingBuffer& operator=(MpmcRingBuffer const&) = delete;
+
+    /**
+     * @brief capacity
+     * @return
+     */
+    size_t capacity() const
+    {
+        return m_mask + 1;
+    }
+
+    /**
+     * @brief try push value, thread safe for producers
+     * @param value - moved only on success
+     * @return false if buffer is full
+     */
+    bool tryPush(T&& value)
+    {
+        Slot* slot = nullptr;
+        auto pos = m_enqueuePos.load(std::memory_order_relaxed);
+
+        while (true)
+        {
+            slot = &m_slots[pos & m_mask];
+            auto const sequence = slot->sequence.load(std::memory_order_acquire);
+            auto const diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos);
+
+            if (diff == 0)
+            {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->value = std::move(value);
+        slot->sequence.store(pos + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    /**
+     * @brief try pop value, thread safe for consumers
+     * @param value - destination
+     * @return false if buffer is empty
+     */
+    bool tryPop(T& value)
+    {
+        Slot* slot = nullptr;
+        auto pos = m_dequeuePos.load(std::memory_order_relaxed);
+
+        while (true)
+        {
+            slot = &m_slots[pos & m_mask];
+            auto const sequence = slot->sequence.load(std::memory_order_acquire);
+            auto const diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos + 1);
+
+            if (diff == 0)
+            {
+                if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = m_dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        value = std::move(slot->value);
+        slot->value = T{};
+        slot->sequence.store(pos + m_mask + 1, std::memory_order_release);
+
+        return true;
+    }
+
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    struct Slot
+    {
+        std::atomic_size_t sequence{0};
+        T value{};
+    };
+
+private:
+    std::unique_ptr<Slot[]> m_slots = nullptr;
+    size_t m_mask = 0;
+
+    alignas(CACHE_LINE_SIZE) std::atomic_size_t m_enqueuePos{0};
+    alignas(CACHE_LINE_SIZE) std::atomic_size_t m_dequeuePos{0};
+};
+}
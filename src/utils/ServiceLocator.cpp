@@ -1,6 +1,10 @@
 #include "ServiceLocator.h"
 
 #include "image/opencv/ImageConvertor.h"
+#include "engines/opencv/TensorEngine.h"
+#include "engines/opencv/TensorEngineSettings.h"
+#include "engines/synthetic/TensorEngine.h"
+#include "engines/synthetic/TensorEngineSettings.h"
 
 #ifdef INCLUDE_TENSOR_RT_BUILD
 #include "engines/tensorRt/TensorEngine.h"
@@ -12,6 +16,11 @@
 #include "engines/torch/TensorEngineSettings.h"
 #endif
 
+#ifdef INCLUDE_ONNX_RUNTIME_BUILD
+#include "engines/onnxruntime/TensorEngine.h"
+#include "engines/onnxruntime/TensorEngineSettings.h"
+#endif
+
 #include <QMetaType>
 
 
@@ -21,6 +30,12 @@ void ServiceLocator::init()
 {
     qRegisterMetaType<common::IEngineInputDataPtr>("IEngineInputDataPtr");
 
+    engines::opencv::TensorEngineSettings::registerSelf(OPENCV);
+    m_tensorEngineContructors.insert(OPENCV, [] () { return std::make_shared<engines::opencv::TensorEngine>(); });
+
+    engines::synthetic::TensorEngineSettings::registerSelf(SYNTHETIC);
+    m_tensorEngineContructors.insert(SYNTHETIC, [] () { return std::make_shared<engines::synthetic::TensorEngine>(); });
+
 #ifdef INCLUDE_TENSOR_RT_BUILD
     engines::tensorRt::TensorEngineSettings::registerSelf(TENSOR_RT);
     m_tensorEngineContructors.insert(TENSOR_RT, [] () { return std::make_shared<engines::tensorRt::TensorEngine>(); });
@@ -30,6 +45,11 @@ void ServiceLocator::init()
     engines::torch::TensorEngineSettings::registerSelf(TORCH);
     m_tensorEngineContructors.insert(TORCH, [] () { return std::make_shared<engines::torch::TensorEngine>(); });
 #endif
+
+#ifdef INCLUDE_ONNX_RUNTIME_BUILD
+    engines::onnxruntime::TensorEngineSettings::registerSelf(ONNX_RUNTIME);
+    m_tensorEngineContructors.insert(ONNX_RUNTIME, [] () { return std::make_shared<engines::onnxruntime::TensorEngine>(); });
+#endif
 }
 
 void ServiceLocator::setTensorEngineType(QString const& type)
@@ -20,6 +20,9 @@ public:
     engines::ITensorEnginePtr createTensorEngine() const;
     image::IImageConvertorPtr createImageConvertor() const;
 
+    static constexpr auto OPENCV = "opencv";
+    static constexpr auto SYNTHETIC = "synthetic";
+
 #ifdef INCLUDE_TENSOR_RT_BUILD
     static constexpr auto TENSOR_RT = "tensorRt";
 #endif
@@ -28,6 +31,10 @@ public:
     static constexpr auto TORCH = "torch";
 #endif
 
+#ifdef INCLUDE_ONNX_RUNTIME_BUILD
+    static constexpr auto ONNX_RUNTIME = "onnxruntime";
+#endif
+
 private:
    using TensorEngineContructor = std::function<engines::ITensorEnginePtr()>;
 
@@ -0,0 +1,133 @@
+#include "ThreadAffinity.h"
+
+#include <QLoggingCategory>
+#include <QStringList>
+#include <QVector>
+#include <QFile>
+
+#ifdef Q_OS_LINUX
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+
+namespace utils
+{
+Q_LOGGING_CATEGORY(QLC_THREAD_AFFINITY, "ThreadAffinity")
+
+static constexpr auto NODE_PREFIX = "node:";
+static constexpr auto NODE_CPULIST = "/sys/devices/system/node/node%1/cpulist";
+
+std::vector<int> ThreadAffinity::parse(QString const& spec)
+{
+    auto const trimmed = spec.trimmed();
+    if (trimmed.isEmpty())
+    {
+        return {};
+    }
+
+    if (trimmed.startsWith(NODE_PREFIX))
+    {
+        bool ok = false;
+        auto const node = trimmed.mid(static_cast<int>(qstrlen(NODE_PREFIX))).toInt(&ok);
+        if (!ok || node < 0)
+        {
+            qCWarning(QLC_THREAD_AFFINITY) << "Invalid NUMA node:" << spec;
+            return {};
+        }
+
+        return nodeCpus(node);
+    }
+
+    std::vector<int> cpus;
+    if (!parseList(trimmed, cpus))
+    {
+        qCWarning(QLC_THREAD_AFFINITY) << "Invalid cpus:" << spec;
+        return {};
+    }
+
+    return cpus;
+}
+
+std::vector<int> ThreadAffinity::nodeCpus(int node)
+{
+    QFile file(QString(NODE_CPULIST).arg(node));
+    if (!file.open(QFile::ReadOnly | QFile::Text))
+    {
+        qCWarning(QLC_THREAD_AFFINITY) << "Cannot read cpus of NUMA node" << node << "error:" << file.errorString();
+        return {};
+    }
+
+    std::vector<int> cpus;
+    if (!parseList(QString::fromLatin1(file.readAll()).trimmed(), cpus))
+    {
+        qCWarning(QLC_THREAD_AFFINITY) << "Invalid cpus of NUMA node" << node;
+        return {};
+    }
+
+    return cpus;
+}
+
+bool ThreadAffinity::pinCurrentThread(std::vector<int> const& cpus)
+{
+    if (cpus.empty())
+    {
+        return false;
+    }
+
+#ifdef Q_OS_LINUX
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (auto const cpu : cpus)
+    {
+        if (cpu >= 0 && cpu < CPU_SETSIZE)
+        {
+            CPU_SET(cpu, &set);
+        }
+    }
+
+    auto const error = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (error != 0)
+    {
+        qCWarning(QLC_THREAD_AFFINITY) << "Cannot pin thread, error:" << error;
+        return false;
+    }
+
+    qCDebug(QLC_THREAD_AFFINITY) << "Thread pinned to cpus:" << QVector<int>(cpus.begin(), cpus.end());
+    return true;
+#else
+    qCWarning(QLC_THREAD_AFFINITY) << "Pinning threads is not supported";
+    return false;
+#endif
+}
+
+bool ThreadAffinity::parseList(QString const& list, std::vector<int>& cpus)
+{
+    for (auto const& item : list.split(','))
+    {
+        if (item.trimmed().isEmpty())
+        {
+            continue;
+        }
+
+        // single cpu is range with equal bounds
+        auto const range = item.split('-');
+        bool okFirst = false;
+        bool okLast = false;
+        auto const first = range.first().trimmed().toInt(&okFirst);
+        auto const last = range.last().trimmed().toInt(&okLast);
+
+        if (range.size() > 2 || !okFirst || !okLast || first < 0 || last < first)
+        {
+            return false;
+        }
+
+        for (int cpu = first; cpu <= last; ++cpu)
+        {
+            cpus.push_back(cpu);
+        }
+    }
+
+    return !cpus.empty();
+}
+}
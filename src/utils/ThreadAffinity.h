@@ -0,0 +1,41 @@
+#pragma once
+
+#include <QString>
+
+#include <vector>
+
+
+namespace utils
+{
+/**
+ * @brief The ThreadAffinity class - pinning threads to cpus or NUMA nodes
+ */
+class ThreadAffinity
+{
+public:
+    /**
+     * @brief parse cpus
+     * @param spec - list of cpus and ranges ("0-7,16,18-19") or NUMA node ("node:0")
+     * @return cpus (empty if spec is empty or invalid)
+     */
+    static std::vector<int> parse(QString const& spec);
+
+    /**
+     * @brief cpus of NUMA node
+     * @param node - NUMA node
+     * @return cpus (empty if node is not exist)
+     */
+    static std::vector<int> nodeCpus(int node);
+
+    /**
+     * @brief pin current thread to cpus
+     * memory first touched by pinned thread is allocated on its NUMA node
+     * @param cpus
+     * @return success
+     */
+    static bool pinCurrentThread(std::vector<int> const& cpus);
+
+private:
+    static bool parseList(QString const& list, std::vector<int>& cpus);
+};
+}
@@ -0,0 +1,268 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <condition_variable>
+
+
+namespace utils
+{
+/**
+ * @brief The WorkStealingExecutor class - pool of threads, each with own deques of tasks by priority level
+ * tasks are pushed to threads by round robin, thread takes own task or steals from others,
+ * task with higher level is taken first across all threads
+ */
+template <typename T, size_t Levels>
+class WorkStealingExecutor
+{
+public:
+    using Handler = std::function<void(T*)>;
+    using ThreadInit = std::function<void()>;
+
+    /**
+     * @param threads - count of threads
+     * @param handler - called for each task in executor thread
+     * @param threadInit - called once in each executor thread before handling tasks
+     */
+    WorkStealingExecutor(size_t threads, Handler const& handler, ThreadInit const& threadInit = {})
+        : m_handler(handler)
+        , m_threadInit(threadInit)
+    {
+        threads = std::max<size_t>(threads, 1);
+        for (size_t i = 0; i < threads; ++i)
+        {
+            m_queues.push_back(std::make_unique<Queue>());
+        }
+    }
+
+    ~WorkStealingExecutor()
+    {
+        stop();
+    }
+
+    WorkStealingExecutor(WorkStealingExecutor const&) = delete;
+    WorkStealingExecutor& operator=(WorkStealingExecutor const&) = delete;
+
+    /**
+     * @brief count of threads
+     * @return
+     */
+    size_t threads() const
+    {
+        return m_queues.size();
+    }
+
+    /**
+     * @brief start threads
+     */
+    void start()
+    {
+        if (!m_threads.empty())
+        {
+            return;
+        }
+
+        m_stop = false;
+        for (size_t i = 0; i < m_queues.size(); ++i)
+        {
+            m_threads.emplace_back(&WorkStealingExecutor::run, this, i);
+        }
+    }
+
+    /**
+     * @brief stop threads after all queued tasks are handled
+     */
+    void stop()
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_idleMutex);
+            m_stop = true;
+        }
+        m_idleNotifier.notify_all();
+
+        for (auto& thread : m_threads)
+        {
+            thread.join();
+        }
+        m_threads.clear();
+    }
+
+    /**
+     * @brief push task, thread safe
+     * @param task
+     * @param level - priority level, clamped to [0, Levels)
+     */
+    void push(T* task, int level)
+    {
+        level = std::clamp<int>(level, 0, Levels - 1);
+
+        auto& queue = *m_queues[m_nextQueue.fetch_add(1, std::memory_order_relaxed) % m_queues.size()];
+        {
+            std::unique_lock<std::mutex> lock(queue.mutex);
+            queue.tasks[level].push_back(task);
+            queue.sizes[level]++;
+        }
+
+        // size is published before checking sleepers, sleeper checks sizes after registering itself
+        if (m_sleeping.load() > 0)
+        {
+            std::unique_lock<std::mutex> lock(m_idleMutex);
+            m_idleNotifier.notify_one();
+        }
+    }
+
+    /**
+     * @brief take first queued task matched by predicate, thread safe
+     * @param predicate
+     * @return task (nullptr if not found)
+     */
+    template <typename Predicate>
+    T* take(Predicate const& predicate)
+    {
+        for (auto& queue : m_queues)
+        {
+            std::unique_lock<std::mutex> lock(queue->mutex);
+            for (size_t level = 0; level < Levels; ++level)
+            {
+                auto& tasks = queue->tasks[level];
+                auto const it = std::find_if(tasks.begin(), tasks.end(), predicate);
+                if (it != tasks.end())
+                {
+                    auto const task = *it;
+                    tasks.erase(it);
+                    queue->sizes[level]--;
+                    return task;
+                }
+            }
+        }
+
+        return nullptr;
+    }
+
+    /**
+     * @brief count of queued and running tasks with level not less than min level
+     * @param minLevel
+     * @return
+     */
+    int size(int minLevel = 0) const
+    {
+        minLevel = std::clamp<int>(minLevel, 0, Levels - 1);
+
+        int size = 0;
+        for (auto const& queue : m_queues)
+        {
+            for (auto level = static_cast<size_t>(minLevel); level < Levels; ++level)
+            {
+                size += queue->sizes[level].load(std::memory_order_relaxed);
+            }
+            size += queue->running.load(std::memory_order_relaxed) >= minLevel;
+        }
+
+        return size;
+    }
+
+private:
+    struct alignas(64) Queue
+    {
+        std::mutex mutex{};
+        std::array<std::deque<T*>, Levels> tasks{};
+        std::array<std::atomic_int, Levels> sizes{};
+        // level of task handled by owner thread (-1 - idle)
+        std::atomic_int running{-1};
+    };
+
+private:
+    void run(size_t index)
+    {
+        if (m_threadInit)
+        {
+            m_threadInit();
+        }
+
+        auto& own = *m_queues[index];
+        while (true)
+        {
+            if (auto const task = takeNext(index))
+            {
+                m_handler(task);
+                own.running.store(-1, std::memory_order_relaxed);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(m_idleMutex);
+            m_sleeping++;
+            if (!hasQueued())
+            {
+                if (m_stop)
+                {
+                    m_sleeping--;
+                    break;
+                }
+                m_idleNotifier.wait(lock);
+            }
+            m_sleeping--;
+        }
+    }
+
+    T* takeNext(size_t index)
+    {
+        // own queue is checked first on each level, then others by order
+        for (int level = Levels - 1; level >= 0; --level)
+        {
+            for (size_t i = 0; i < m_queues.size(); ++i)
+            {
+                auto& queue = *m_queues[(index + i) % m_queues.size()];
+                if (queue.sizes[level].load() == 0)
+                {
+                    continue;
+                }
+
+                std::unique_lock<std::mutex> lock(queue.mutex);
+                auto& tasks = queue.tasks[level];
+                if (tasks.empty())
+                {
+                    continue;
+                }
+
+                auto const task = tasks.front();
+                tasks.pop_front();
+                m_queues[index]->running.store(level, std::memory_order_relaxed);
+                queue.sizes[level]--;
+
+                return task;
+            }
+        }
+
+        return nullptr;
+    }
+
+    bool hasQueued() const
+    {
+        return std::any_of(m_queues.begin(), m_queues.end(), [] (auto const& queue) {
+            return std::any_of(queue->sizes.begin(), queue->sizes.end(), [] (auto const& size) {
+                return size.load() > 0;
+            });
+        });
+    }
+
+private:
+    Handler m_handler{};
+    ThreadInit m_threadInit{};
+
+    std::vector<std::unique_ptr<Queue>> m_queues{};
+    std::vector<std::thread> m_threads{};
+    std::atomic_size_t m_nextQueue{0};
+
+    std::mutex m_idleMutex{};
+    std::condition_variable m_idleNotifier{};
+    std::atomic_int m_sleeping{0};
+    bool m_stop = false;
+};
+}
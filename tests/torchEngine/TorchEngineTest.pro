@@ -0,0 +1,36 @@
+QT -= gui
+QT += testlib
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+TARGET = TorchEngineTest
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+HEADERS += \
+    ../../src/engines/BaseTensorEngine.h \
+    ../../src/engines/BaseTensorEngineSettings.h \
+    ../../src/engines/ITensorEngine.h \
+    ../../src/engines/torch/TensorEngine.h \
+    ../../src/engines/torch/TensorEngineSettings.h \
+    ../../src/utils/ThreadAffinity.h \
+    src/InferenceModeTest.h
+
+SOURCES += \
+    ../../src/engines/BaseTensorEngine.cpp \
+    ../../src/engines/BaseTensorEngineSettings.cpp \
+    ../../src/engines/torch/TensorEngine.cpp \
+    ../../src/engines/torch/TensorEngineSettings.cpp \
+    ../../src/utils/ThreadAffinity.cpp \
+    src/InferenceModeTest.cpp
+
+INCLUDEPATH += ../../src/ src/
+
+INCLUDEPATH += $$(TORCH_ROOT)/include
+DEPENDPATH += $$(TORCH_ROOT)/include
+
+INCLUDEPATH += $$(TORCH_ROOT)/include/torch/csrc/api/include/
+DEPENDPATH += $$(TORCH_ROOT)/include/torch/csrc/api/include/
+
+LIBS += -L$$(TORCH_ROOT)/lib/ -ltorch -lnnpack -lc10
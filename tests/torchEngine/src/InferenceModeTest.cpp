@@ -0,0 +1,110 @@
+#include "InferenceModeTest.h"
+#include "engines/torch/TensorEngine.h"
+
+#include <QJsonObject>
+#include <QtTest>
+
+#include <vector>
+
+
+namespace test
+{
+static constexpr int WIDTH = 2;
+static constexpr int HEIGHT = 2;
+static constexpr int CHANNELS = 1;
+static constexpr int OUTPUT = 2;
+
+/**
+ * @brief The ProbeEngine class - torch engine which checks state of infer thread,
+ * prepareThreadImpl is called on infer thread after its context is created
+ */
+class ProbeEngine : public engines::torch::TensorEngine
+{
+public:
+    void prepareThreadImpl(size_t maxThreads, std::vector<int> const& cpus) override
+    {
+        inferenceMode = c10::InferenceMode::is_enabled();
+        gradMode = at::GradMode::is_enabled();
+        TensorEngine::prepareThreadImpl(maxThreads, cpus);
+    }
+
+    ::torch::Tensor forwardOutput() const
+    {
+        return output().toTensor();
+    }
+
+    bool inferenceMode = false;
+    bool gradMode = true;
+};
+
+static engines::BaseTensorEngineSettings settings(QString const& modelPath)
+{
+    engines::BaseTensorEngineSettings settings;
+    settings.parse(QJsonObject{
+                       {"type", "torch"},
+                       {"maxBatches", 2},
+                       {"countTestsForEstimate", 1},
+                       {"positiveIndex", 1},
+                       {"negativeIndex", 0},
+                       {"torch", QJsonObject{
+                            {"width", WIDTH},
+                            {"height", HEIGHT},
+                            {"channels", CHANNELS},
+                            {"output", OUTPUT},
+                            {"modelPath", modelPath}
+                        }}
+                   });
+    return settings;
+}
+
+void InferenceModeTest::initTestCase()
+{
+    engines::torch::TensorEngineSettings::registerSelf("torch");
+
+    QVERIFY(m_dir.isValid());
+    m_modelPath = m_dir.filePath("scale.pt");
+
+    // weight requires grad, so output of forward without inference mode would record graph
+    ::torch::jit::Module module("Scale");
+    module.register_parameter("weight", ::torch::ones({1}, ::torch::requires_grad()), false);
+    module.define("def forward(self, x):\n"
+                  "    return x.flatten(1)[:, :2] * self.weight\n");
+    module.save(qPrintable(m_modelPath));
+}
+
+void InferenceModeTest::inferThreadContext()
+{
+    ProbeEngine engine;
+    QVERIFY(engine.load(settings(m_modelPath)));
+
+    engine.prepareThread(1, {});
+
+    QVERIFY(engine.inferenceMode);
+    QVERIFY(!engine.gradMode);
+    QVERIFY(!c10::InferenceMode::is_enabled());
+}
+
+void InferenceModeTest::forwardOutput()
+{
+    ProbeEngine engine;
+    QVERIFY(engine.load(settings(m_modelPath)));
+
+    std::vector<float> const input(engine.batchInputN(), 1.0f);
+    for (size_t batch = 0; batch < engine.maxBatches(); ++batch)
+    {
+        QVERIFY(engine.loadToInput(batch, 0, input.data(), input.size()));
+    }
+    QVERIFY(engine.infer(engine.maxBatches()));
+
+    auto const output = engine.forwardOutput();
+    QVERIFY(!output.requires_grad());
+    QVERIFY(!output.grad_fn());
+    QVERIFY(output.is_inference());
+
+    std::vector<float> result(engine.maxBatches() * engine.batchOutputN());
+    QVERIFY(engine.unloadOutput(engine.maxBatches(), result.data()));
+    QCOMPARE(result.front(), 1.0f);
+}
+}
+
+QTEST_GUILESS_MAIN(test::InferenceModeTest)
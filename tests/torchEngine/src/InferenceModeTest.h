@@ -0,0 +1,26 @@
+#pragma once
+
+#include <QObject>
+#include <QTemporaryDir>
+
+
+namespace test
+{
+/**
+ * @brief The InferenceModeTest class - checks that forwards on infer thread of torch engine
+ * run under inference mode and record no autograd graph
+ */
+class InferenceModeTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void inferThreadContext();
+    void forwardOutput();
+
+private:
+    QTemporaryDir m_dir{};
+    QString m_modelPath{};
+};
+}
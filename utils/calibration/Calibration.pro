@@ -0,0 +1,47 @@
+QT -= gui
+
+CONFIG += c++17 console
+CONFIG += file_copies
+CONFIG -= app_bundle
+
+TARGET = CalibrationDump
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+HEADERS += \
+    ../../src/engines/BaseTensorEngine.h \
+    ../../src/engines/BaseTensorEngineSettings.h \
+    ../../src/engines/ITensorEngine.h \
+    ../../src/image/IImageConvertor.h \
+    ../../src/image/ImageConvertorSettings.h \
+    ../../src/image/opencv/ImageConvertor.h \
+    ../../src/utils/ThreadAffinity.h \
+    src/CaptureEngine.h
+
+SOURCES += \
+    ../../src/engines/BaseTensorEngine.cpp \
+    ../../src/engines/BaseTensorEngineSettings.cpp \
+    ../../src/image/ImageConvertorSettings.cpp \
+    ../../src/image/opencv/ImageConvertor.cpp \
+    ../../src/utils/ThreadAffinity.cpp \
+    src/CaptureEngine.cpp \
+    src/main.cpp
+
+COPIES += resources_files
+
+resources_files.files = $$PWD/../../resources/settings.json
+resources_files.path = $$OUT_PWD
+
+INCLUDEPATH += ../../src/ src/
+
+INCLUDEPATH += $$(OPENCV_INCLUDE)
+DEPENDPATH += $$(OPENCV_INCLUDE)
+
+OPENCV_LIBS_EXIST = $$(OPENCV_LIBS)
+
+isEmpty(OPENCV_LIBS_EXIST) {
+LIBS += -lopencv_core -lopencv_imgproc -lopencv_imgcodecs
+}
+else {
+LIBS += -L$$(OPENCV_LIBS) -lopencv_core -lopencv_imgproc -lopencv_imgcodecs
+}
@@ -0,0 +1,81 @@
+#include "CaptureEngine.h"
+
+#include <algorithm>
+
+
+namespace calibration
+{
+CaptureEngine::CaptureEngine(size_t width, size_t height, size_t channels)
+    : m_width(width)
+    , m_height(height)
+    , m_channels(channels)
+    , m_input(width * height * channels)
+{
+}
+
+std::vector<CaptureEngine::Tensor> const& CaptureEngine::input() const
+{
+    return m_input;
+}
+
+bool CaptureEngine::loadImpl(engines::BaseTensorEngineSettings const&)
+{
+    return true;
+}
+
+bool CaptureEngine::inferImpl(size_t, size_t)
+{
+    return false;
+}
+
+size_t CaptureEngine::maxBatches() const
+{
+    return 1;
+}
+
+size_t CaptureEngine::inputWidth() const
+{
+    return m_width;
+}
+
+size_t CaptureEngine::inputHeight() const
+{
+    return m_height;
+}
+
+size_t CaptureEngine::inputChannels() const
+{
+    return m_channels;
+}
+
+size_t CaptureEngine::outputSize() const
+{
+    return 0;
+}
+
+bool CaptureEngine::loadToInput(size_t batch, size_t offset, Tensor const* src, size_t n)
+{
+    if (!validateLoadInput(batch, offset, src, n))
+    {
+        return false;
+    }
+
+    std::copy(src, src + n, m_input.begin() + static_cast<std::ptrdiff_t>(offset));
+    return true;
+}
+
+bool CaptureEngine::unloadOutput(size_t, Tensor*)
+{
+    return false;
+}
+
+size_t CaptureEngine::batchInputN() const
+{
+    return m_input.size();
+}
+
+size_t CaptureEngine::batchOutputN() const
+{
+    return 0;
+}
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "engines/BaseTensorEngine.h"
+
+#include <vector>
+
+
+namespace calibration
+{
+/**
+ * @brief The CaptureEngine class - tensor engine which only keeps loaded input of one image,
+ * so prepared data of image convertor can be saved exactly as real engine receives it
+ */
+class CaptureEngine : public engines::BaseTensorEngine
+{
+public:
+    CaptureEngine(size_t width, size_t height, size_t channels);
+
+    /**
+     * @brief loaded input of image in CHW layout
+     * @return
+     */
+    std::vector<Tensor> const& input() const;
+
+public: // BaseTensorEngine interface
+    bool loadImpl(engines::BaseTensorEngineSettings const& settings) override;
+    bool inferImpl(size_t buffer, size_t batches) override;
+
+public: // ITensorEngine interface
+    size_t maxBatches() const override;
+    size_t inputWidth() const override;
+    size_t inputHeight() const override;
+    size_t inputChannels() const override;
+    size_t outputSize() const override;
+    bool loadToInput(size_t batch, size_t offset, Tensor const* src, size_t n) override;
+    bool unloadOutput(size_t batches, Tensor* dst) override;
+    size_t batchInputN() const override;
+    size_t batchOutputN() const override;
+
+private:
+    size_t m_width = 0;
+    size_t m_height = 0;
+    size_t m_channels = 0;
+    std::vector<Tensor> m_input{};
+};
+}
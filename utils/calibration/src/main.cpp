@@ -0,0 +1,165 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QLoggingCategory>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+#include <QFileInfo>
+#include <QFile>
+#include <QDir>
+
+#include "CaptureEngine.h"
+#include "image/opencv/ImageConvertor.h"
+
+
+Q_LOGGING_CATEGORY(QLC_CALIBRATION, "Calibration")
+
+static constexpr int CHANNELS = 3;
+static constexpr int NPY_ALIGNMENT = 64;
+static QStringList const IMAGE_FILTERS = {"*.jpg", "*.jpeg", "*.png", "*.bmp"};
+
+static bool readSettings(QString const& path, image::ImageConvertorSettings& settings)
+{
+    QFile file(path);
+    if (!file.open(QFile::ReadOnly | QFile::Text))
+    {
+        qCCritical(QLC_CALIBRATION) << "Cannot open settings:" << path << "error:" << file.errorString();
+        return false;
+    }
+
+    auto const json = QJsonDocument::fromJson(file.readAll()).object();
+    return settings.parse(json.value("image").toObject());
+}
+
+/**
+ * @brief write float32 array in numpy .npy format (version 1.0)
+ * @param path
+ * @param data
+ * @param shape
+ * @return success
+ */
+static bool writeNpy(QString const& path, std::vector<float> const& data, QList<size_t> const& shape)
+{
+    QStringList dims;
+    for (auto const dim : shape)
+    {
+        dims.append(QString::number(dim));
+    }
+
+    auto header = QString("{'descr': '<f4', 'fortran_order': False, 'shape': (%1,), }").arg(dims.join(", ")).toLatin1();
+
+    // magic, version and length of header precede header, total is aligned and ends with new line
+    auto const prefix = 10;
+    auto const padding = NPY_ALIGNMENT - (prefix + header.size() + 1) % NPY_ALIGNMENT;
+    header += QByteArray(padding % NPY_ALIGNMENT, ' ') + '\n';
+
+    QByteArray out("\x93NUMPY\x01\x00", 8);
+    out += static_cast<char>(header.size() & 0xFF);
+    out += static_cast<char>((header.size() >> 8) & 0xFF);
+    out += header;
+
+    QFile file(path);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate))
+    {
+        qCCritical(QLC_CALIBRATION) << "Cannot open file:" << path << "error:" << file.errorString();
+        return false;
+    }
+
+    auto const bytes = static_cast<qint64>(data.size() * sizeof(float));
+    if (file.write(out) != out.size() || file.write(reinterpret_cast<char const*>(data.data()), bytes) != bytes)
+    {
+        qCCritical(QLC_CALIBRATION) << "Cannot write file:" << path << "error:" << file.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+int main(int argn, char* argv[])
+{
+    qSetMessagePattern("%{time hh:mm::ss.zzz} [%{type}] %{category}: %{message}");
+    QLoggingCategory::setFilterRules("*.debug=false");
+
+    QCoreApplication app(argn, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Dump images prepared by image convertor as numpy array for quantization calibration");
+    parser.addHelpOption();
+
+    QCommandLineOption const settingsOption("settings", "Path to settings with image section.", "path", "settings.json");
+    QCommandLineOption const imagesOption("images", "Directory with sample images.", "dir");
+    QCommandLineOption const widthOption("width", "Width of input of network.", "px", "224");
+    QCommandLineOption const heightOption("height", "Height of input of network.", "px", "224");
+    QCommandLineOption const limitOption("limit", "Max count of images (0 - all).", "n", "0");
+    QCommandLineOption const outputOption("output", "Path to numpy array [N, C, H, W].", "path", "calibration.npy");
+    parser.addOptions({settingsOption, imagesOption, widthOption, heightOption, limitOption, outputOption});
+    parser.process(app);
+
+    image::ImageConvertorSettings settings;
+    if (!readSettings(parser.value(settingsOption), settings))
+    {
+        return 1;
+    }
+    settings.setWidth(parser.value(widthOption).toInt());
+    settings.setHeight(parser.value(heightOption).toInt());
+    settings.setChannels(CHANNELS);
+
+    image::opencv::ImageConvertor convertor;
+    if (!parser.isSet(imagesOption) || !convertor.load(settings))
+    {
+        qCCritical(QLC_CALIBRATION) << "Invalid options, see --help";
+        return 1;
+    }
+
+    calibration::CaptureEngine capture(static_cast<size_t>(settings.width()), static_cast<size_t>(settings.height()),
+                                       static_cast<size_t>(settings.channels()));
+
+    auto const limit = parser.value(limitOption).toInt();
+    auto const images = QDir(parser.value(imagesOption)).entryInfoList(IMAGE_FILTERS, QDir::Files, QDir::Name);
+
+    std::vector<float> data;
+    QStringList prepared;
+    for (auto const& image : images)
+    {
+        if (limit > 0 && prepared.size() >= limit)
+        {
+            break;
+        }
+
+        // the same path as request of service with image path
+        auto const input = convertor.convert(image.absoluteFilePath());
+        if (!input || !input->load(0, capture))
+        {
+            qCWarning(QLC_CALIBRATION) << "Image is skipped:" << image.absoluteFilePath();
+            continue;
+        }
+
+        data.insert(data.end(), capture.input().begin(), capture.input().end());
+        prepared.append(image.absoluteFilePath());
+    }
+
+    if (prepared.isEmpty())
+    {
+        qCCritical(QLC_CALIBRATION) << "No images prepared from:" << parser.value(imagesOption);
+        return 1;
+    }
+
+    auto const output = parser.value(outputOption);
+    QList<size_t> const shape = {static_cast<size_t>(prepared.size()), capture.inputChannels(),
+                                 capture.inputHeight(), capture.inputWidth()};
+    if (!writeNpy(output, data, shape))
+    {
+        return 1;
+    }
+
+    // order of images in array
+    QFileInfo const info(output);
+    QFile list(info.dir().filePath(info.completeBaseName() + ".txt"));
+    if (list.open(QFile::WriteOnly | QFile::Truncate | QFile::Text))
+    {
+        QTextStream(&list) << prepared.join('\n') << '\n';
+    }
+
+    qCInfo(QLC_CALIBRATION) << "Prepared" << prepared.size() << "images to" << output;
+    return 0;
+}
@@ -3,12 +3,13 @@
 function printHelp {
 cat << EOF
 usage:
-    --tensor-engine: tensor engine type (torch|tensorRt), if not specified will be setup from json
+    --tensor-engine: tensor engine type (torch|tensorRt|onnxruntime|opencv|synthetic), if not specified will be setup from json
     --qtlib: path to qt lib folder
     --opencvlib: path to opencv lib folder
     --cudalib: path to cuda lib folder
     --tensorrtlib: path to tensorrt lib filder
     --torchlib: path to torch lib folder
+    --onnxruntimelib: path to onnx runtime lib folder
     --help: print usage
 EOF
 }
@@ -40,6 +41,10 @@ case $i in
     TORCH_LIB_DIR="${i#*=}"
     shift
     ;;
+    --onnxruntimelib=*)
+    ONNX_RUNTIME_LIB_DIR="${i#*=}"
+    shift
+    ;;
     --help)
     printHelp
     exit 0
@@ -69,12 +74,22 @@ function checkTorch {
     if [ -z "$TORCH_LIB_DIR" ]; then echo "--torchlib is not set!"; exit 1; fi;
 }
 
+function checkOnnxRuntime {
+    if [ -z "$ONNX_RUNTIME_LIB_DIR" ]; then echo "--onnxruntimelib is not set!"; exit 1; fi;
+}
+
 if [ $TENSOR_ENGINE == "tensorRt" ]
 then
 checkTensorRt
 elif [ $TENSOR_ENGINE == "torch" ]
 then
 checkTorch
+elif [ $TENSOR_ENGINE == "onnxruntime" ]
+then
+checkOnnxRuntime
+elif [ $TENSOR_ENGINE == "opencv" ] || [ $TENSOR_ENGINE == "synthetic" ]
+then
+:
 else
 checkTensorRt
 checkTorch
@@ -84,6 +99,7 @@ if [ -n "$OPENCV_LIB_DIR" ]; then LD_LIBRARY_PATH=$OPENCV_LIB_DIR:$LD_LIBRARY_PA
 if [ -n "$CUDA_LIB_DIR" ]; then LD_LIBRARY_PATH=$CUDA_LIB_DIR:$LD_LIBRARY_PATH; fi;
 if [ -n "$TENSOR_RT_LIB_DIR" ]; then LD_LIBRARY_PATH=$TENSOR_RT_LIB_DIR:$LD_LIBRARY_PATH; fi;
 if [ -n "$TORCH_LIB_DIR" ]; then LD_LIBRARY_PATH=$TORCH_LIB_DIR:$LD_LIBRARY_PATH; fi;
+if [ -n "$ONNX_RUNTIME_LIB_DIR" ]; then LD_LIBRARY_PATH=$ONNX_RUNTIME_LIB_DIR:$LD_LIBRARY_PATH; fi;
 LD_LIBRARY_PATH=$QT_LIB_DIR:$OPENCV_LIB_DIR:$LD_LIBRARY_PATH
 
 ./SkinCancerDetectorService --tensor-engine=$TENSOR_ENGINE
@@ -1,6 +1,23 @@
+import argparse
+import copy
+import json
+
 import torch
 import torch.onnx
 
+parser = argparse.ArgumentParser(description="Convert model to ONNX and TorchScript, optionally quantized to INT8")
+parser.add_argument("--quantize", choices=["static", "dynamic"],
+                    help="also save INT8 TorchScript model skin_cancer_detector_int8.pth")
+parser.add_argument("--calibration", default="calibration.npy",
+                    help="images prepared by CalibrationDump (utils/calibration), array [N, C, H, W]")
+parser.add_argument("--backend", choices=["fbgemm", "qnnpack"], default="fbgemm",
+                    help="backend of quantized kernels, should match quantizedEngine in settings")
+parser.add_argument("--eval-part", type=float, default=0.2,
+                    help="part of calibration images kept for accuracy report")
+parser.add_argument("--positive-index", type=int, default=1,
+                    help="positive index of output, should match positiveIndex in settings")
+args = parser.parse_args()
+
 device = torch.device("cpu")
 model = torch.load("model.uu", map_location='cpu')
 model.to(device)
@@ -16,8 +33,66 @@ torch.onnx.export(model,
                   opset_version=9,
                   verbose=True)
 
+# batch dimension is dynamic for engines which forward batches of any size (ONNX Runtime)
+torch.onnx.export(model,
+                  dummy,
+                  "skin_cancer_detector_dynamic.onnx",
+                  export_params=True,
+                  do_constant_folding=True,
+                  opset_version=11,
+                  input_names=["input"],
+                  output_names=["output"],
+                  dynamic_axes={"input": {0: "batches"}, "output": {0: "batches"}})
+
 dummy = torch.ones((1, 3, 224, 224))
 
 scripted_model = torch.jit.trace(model, dummy)
 scripted_model.save('skin_cancer_detector.pth')
 
+if args.quantize:
+    import numpy as np
+    from torch.ao.quantization import get_default_qconfig_mapping, quantize_dynamic
+    from torch.ao.quantization.quantize_fx import convert_fx, prepare_fx
+
+    torch.backends.quantized.engine = args.backend
+
+    # images are prepared by the same image convertor as in service
+    images = torch.from_numpy(np.load(args.calibration))
+    evaluated = int(len(images) * args.eval_part)
+    if evaluated == 0 or evaluated == len(images):
+        print("Too few images for separate evaluation, all images are used for calibration and evaluation")
+        calibration, evaluation = images, images
+    else:
+        calibration, evaluation = images[:-evaluated], images[-evaluated:]
+
+    with torch.no_grad():
+        if args.quantize == "static":
+            # observers collect ranges of activations on calibration images
+            prepared = prepare_fx(copy.deepcopy(model), get_default_qconfig_mapping(args.backend), (dummy,))
+            for batch in calibration.split(8):
+                prepared(batch)
+            quantized = convert_fx(prepared)
+        else:
+            quantized = quantize_dynamic(copy.deepcopy(model), {torch.nn.Linear}, dtype=torch.qint8)
+        quantized.eval()
+
+        reference = torch.cat([model(batch) for batch in evaluation.split(8)])
+        actual = torch.cat([quantized(batch) for batch in evaluation.split(8)])
+
+    delta = (actual[:, args.positive_index] - reference[:, args.positive_index]).abs()
+    report = {
+        "mode": args.quantize,
+        "backend": args.backend,
+        "calibrationImages": len(calibration),
+        "evaluationImages": len(evaluation),
+        "top1Agreement": (actual.argmax(1) == reference.argmax(1)).float().mean().item(),
+        "positiveMeanAbsDelta": delta.mean().item(),
+        "positiveMaxAbsDelta": delta.max().item(),
+    }
+
+    with open("quantization_report.json", "w") as file:
+        json.dump(report, file, indent=4)
+    print(json.dumps(report, indent=4))
+
+    scripted_quantized = torch.jit.trace(quantized, dummy)
+    scripted_quantized.save('skin_cancer_detector_int8.pth')